@@ -0,0 +1,485 @@
+#include "SudokuAdvancedChecks.hpp"
+#include "SudokuGenerator.hpp"
+#include "SudokuGridSolver.hpp"
+#include "SudokuHistogram.hpp"
+#include "SudokuLineReader.hpp"
+#include "SudokuSamurai.hpp"
+#include "SudokuSolver.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifndef SUDOKU_BENCH_DATA
+#define SUDOKU_BENCH_DATA "bench/data"
+#endif
+
+namespace
+{
+    // Bundled corpora, easiest first
+    const char *const CORPORA[] = {"easy", "17clue", "hard"};
+
+    // Extra timings of each slow-seed candidate in latency mode
+    const int RERUNS = 2;
+
+    struct Options
+    {
+        std::string dataDir = SUDOKU_BENCH_DATA;
+        std::string jsonFile;   // Empty for no JSON, "-" for stdout
+        int rounds = 5;         // Passes over each corpus
+        int generate = 50;      // Puzzles generated per difficulty
+        unsigned int seed = 1;  // Generator seed, reset before each difficulty
+        int latency = 0;        // Latency mode: puzzles per difficulty, one seed each
+        int slowest = 10;       // Latency mode: slowest seeds reported per difficulty
+    };
+
+    // Timings of one benchmark: every call lands in the histogram
+    struct Result
+    {
+        std::string name;
+        SudokuHistogram latency;
+        long long nodes = -1; // Search nodes over all calls; -1 if the call does not search
+        long long solved = 0;
+    };
+
+    // A generatePuzzle call in latency mode, replayable from its seed
+    struct SlowCase
+    {
+        uint64_t nanos;      // Best of 1 + RERUNS timings
+        uint64_t firstNanos; // The timing in the histogram
+        unsigned int seed;
+    };
+
+    // Latency of every generatePuzzle call at one difficulty
+    struct LatencyResult
+    {
+        std::string name;
+        SudokuHistogram latency;
+        std::vector<SlowCase> slowest; // Slowest first, by best of 1 + RERUNS timings
+    };
+
+    // One timed call on a scratch copy of a puzzle: true if it solved it; adds its
+    // search nodes to stats
+    using Call = std::function<bool(SudokuBoard &, SolverStats &)>;
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "Usage: sudoku_bench [options]\n"
+                     "  --data DIR       Corpus directory (default %s)\n"
+                     "  --json FILE      Also write results as JSON to FILE ('-': stdout, no table)\n"
+                     "  --rounds N       Passes over each corpus (default 5)\n"
+                     "  --generate N     Puzzles generated per difficulty (default 50)\n"
+                     "  --seed N         Generator seed (default 1)\n"
+                     "  --latency N      Only time N generatePuzzle calls per difficulty, seeding\n"
+                     "                   each with the next seed from --seed\n"
+                     "  --slowest K      Slowest seeds listed per difficulty (default 10)\n",
+                     SUDOKU_BENCH_DATA);
+    }
+
+    bool parseOptions(int argc, char *argv[], Options &options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--data" && hasValue)
+                options.dataDir = argv[++i];
+            else if (arg == "--json" && hasValue)
+                options.jsonFile = argv[++i];
+            else if (arg == "--rounds" && hasValue)
+                options.rounds = std::atoi(argv[++i]);
+            else if (arg == "--generate" && hasValue)
+                options.generate = std::atoi(argv[++i]);
+            else if (arg == "--seed" && hasValue)
+                options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+            else if (arg == "--latency" && hasValue)
+                options.latency = std::atoi(argv[++i]);
+            else if (arg == "--slowest" && hasValue)
+                options.slowest = std::atoi(argv[++i]);
+            else
+                return false;
+        }
+        // Seed 0 leaves SudokuProject generate unseeded, so it could not replay a case
+        return options.rounds > 0 && options.generate >= 0 && options.latency >= 0 && options.slowest >= 0 &&
+               options.seed != 0;
+    }
+
+    bool loadCorpus(const std::string &filename, std::vector<SudokuBoard> &puzzles)
+    {
+        SudokuLineReader reader;
+        if (!reader.open(filename))
+        {
+            return false;
+        }
+        SudokuBoard board;
+        while (reader.next(board))
+        {
+            puzzles.push_back(board);
+        }
+        return !puzzles.empty();
+    }
+
+    uint64_t elapsedNanos(std::chrono::steady_clock::time_point start)
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // Time call on every puzzle, rounds times over; the copy each call gets is made
+    // outside the timed region. One untimed call goes first, so that static setup
+    // does not land in the histogram.
+    Result runCorpus(const std::string &name, const std::vector<SudokuBoard> &puzzles, int rounds, const Call &call,
+                     bool searches)
+    {
+        Result result;
+        result.name = name;
+        SolverStats stats;
+        SudokuBoard work;
+        if (!puzzles.empty())
+        {
+            SolverStats warmUp;
+            work = puzzles[0];
+            call(work, warmUp);
+        }
+        for (int round = 0; round < rounds; round++)
+        {
+            for (const SudokuBoard &puzzle : puzzles)
+            {
+                work = puzzle;
+                auto start = std::chrono::steady_clock::now();
+                bool solved = call(work, stats);
+                result.latency.record(elapsedNanos(start));
+                result.solved += solved ? 1 : 0;
+            }
+        }
+        if (searches)
+        {
+            result.nodes = stats.nodes;
+        }
+        return result;
+    }
+
+    // One grid per line, in the --box (or --variant) text form; lines starting with '#' are comments
+    template <typename Geometry>
+    bool loadGridCorpus(const std::string &filename, std::vector<SudokuGrid<Geometry>> &puzzles)
+    {
+        std::ifstream file(filename);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            SudokuGrid<Geometry> grid;
+            if (!line.empty() && line[0] != '#' && grid.parse(line.data(), line.size()))
+            {
+                puzzles.push_back(grid);
+            }
+        }
+        return !puzzles.empty();
+    }
+
+    // runCorpus for a larger grid: solve, or count solutions when counting
+    template <typename Geometry>
+    Result runGridCorpus(const std::string &name, const std::vector<SudokuGrid<Geometry>> &puzzles, int rounds,
+                         bool counting)
+    {
+        Result result;
+        result.name = name;
+        SolverStats stats;
+        SudokuGrid<Geometry> work;
+        if (!puzzles.empty())
+        {
+            Contradiction contradiction;
+            work = puzzles[0];
+            SudokuGridSolver<Geometry>::solve(work, contradiction); // Untimed warm-up
+        }
+        for (int round = 0; round < rounds; round++)
+        {
+            for (const SudokuGrid<Geometry> &puzzle : puzzles)
+            {
+                work = puzzle;
+                auto start = std::chrono::steady_clock::now();
+                bool solved;
+                if (counting)
+                {
+                    solved = SudokuGridSolver<Geometry>::countSolutions(work, 2, &stats) == 1;
+                }
+                else
+                {
+                    Contradiction contradiction;
+                    solved = SudokuGridSolver<Geometry>::solve(work, contradiction, nullptr, &stats) ==
+                             SolveResult::SOLVED;
+                }
+                result.latency.record(elapsedNanos(start));
+                result.solved += solved ? 1 : 0;
+            }
+        }
+        result.nodes = stats.nodes;
+        return result;
+    }
+
+    // Solve and count over bench/data/<corpus>.txt, a corpus of larger grids
+    template <typename Geometry>
+    bool runGridCorpora(const std::string &corpus, const Options &options, std::vector<Result> &results)
+    {
+        std::vector<SudokuGrid<Geometry>> puzzles;
+        std::string filename = options.dataDir + "/" + corpus + ".txt";
+        if (!loadGridCorpus(filename, puzzles))
+        {
+            std::fprintf(stderr, "Cannot read corpus %s\n", filename.c_str());
+            return false;
+        }
+        results.push_back(runGridCorpus("solve/" + corpus, puzzles, options.rounds, false));
+        results.push_back(runGridCorpus("count/" + corpus, puzzles, options.rounds, true));
+        return true;
+    }
+
+    Result runGenerate(const std::string &name, Difficulty difficulty, const Options &options)
+    {
+        Result result;
+        result.name = name;
+        SudokuGenerator::generatePuzzle(difficulty); // Untimed warm-up
+        SudokuGenerator::setSeed(options.seed);
+        for (int i = 0; i < options.generate; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            SudokuBoard puzzle = SudokuGenerator::generatePuzzle(difficulty);
+            result.latency.record(elapsedNanos(start));
+            result.solved += puzzle.isFull() ? 0 : 1;
+        }
+        return result;
+    }
+
+    // Call i runs from seed + i, so a slow case replays with
+    // SudokuProject generate -d <difficulty> --seed <seed>
+    LatencyResult runLatency(const std::string &name, Difficulty difficulty, const Options &options)
+    {
+        LatencyResult result;
+        result.name = name;
+        std::vector<SlowCase> cases;
+        cases.reserve(static_cast<size_t>(options.latency));
+        SudokuGenerator::generatePuzzle(difficulty); // Untimed warm-up
+        for (int i = 0; i < options.latency; i++)
+        {
+            unsigned int seed = options.seed + static_cast<unsigned int>(i);
+            SudokuGenerator::setSeed(seed);
+            auto start = std::chrono::steady_clock::now();
+            SudokuGenerator::generatePuzzle(difficulty);
+            uint64_t nanos = elapsedNanos(start);
+            result.latency.record(nanos);
+            cases.push_back({nanos, nanos, seed});
+        }
+        // A one-off stall (preemption, page faults) can make any seed look slow, so
+        // rerun a wider set of candidates and rank them by their best time
+        auto slower = [](const SlowCase &a, const SlowCase &b) { return a.nanos > b.nanos; };
+        size_t candidates = std::min(cases.size(), static_cast<size_t>(options.slowest) * 4);
+        std::partial_sort(cases.begin(), cases.begin() + candidates, cases.end(), slower);
+        cases.resize(candidates);
+        for (SlowCase &slow : cases)
+        {
+            for (int rerun = 0; rerun < RERUNS; rerun++)
+            {
+                SudokuGenerator::setSeed(slow.seed);
+                auto start = std::chrono::steady_clock::now();
+                SudokuGenerator::generatePuzzle(difficulty);
+                slow.nanos = std::min(slow.nanos, elapsedNanos(start));
+            }
+        }
+        std::sort(cases.begin(), cases.end(), slower);
+        cases.resize(std::min(cases.size(), static_cast<size_t>(options.slowest)));
+        result.slowest = cases;
+        return result;
+    }
+
+    double perCall(const Result &result, double total)
+    {
+        return result.latency.count() ? total / static_cast<double>(result.latency.count()) : 0.0;
+    }
+
+    void printTable(const std::vector<Result> &results)
+    {
+        std::printf("%-18s %8s %12s %12s %10s %10s %10s %10s\n", "benchmark", "calls", "ns/call", "nodes/call",
+                    "p50", "p90", "p99", "max");
+        for (const Result &result : results)
+        {
+            char nodes[32] = "-";
+            if (result.nodes >= 0)
+            {
+                std::snprintf(nodes, sizeof(nodes), "%.1f", perCall(result, static_cast<double>(result.nodes)));
+            }
+            std::printf("%-18s %8llu %12.0f %12s %10s %10s %10s %10s\n", result.name.c_str(),
+                        static_cast<unsigned long long>(result.latency.count()), result.latency.mean(), nodes,
+                        SudokuHistogram::formatNanos(result.latency.percentile(0.50)).c_str(),
+                        SudokuHistogram::formatNanos(result.latency.percentile(0.90)).c_str(),
+                        SudokuHistogram::formatNanos(result.latency.percentile(0.99)).c_str(),
+                        SudokuHistogram::formatNanos(result.latency.max()).c_str());
+        }
+    }
+
+    // One object per benchmark; nodes_per_call is null where the call does not search
+    void writeJson(std::FILE *out, const Options &options, const std::vector<Result> &results)
+    {
+        std::fprintf(out, "{\n  \"rounds\": %d,\n  \"generate\": %d,\n  \"seed\": %u,\n  \"benchmarks\": [",
+                     options.rounds, options.generate, options.seed);
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const Result &result = results[i];
+            std::fprintf(out, "%s\n    {\"name\": \"%s\", \"calls\": %llu, \"solved\": %lld, \"ns_per_call\": %.1f, ",
+                         i ? "," : "", result.name.c_str(), static_cast<unsigned long long>(result.latency.count()),
+                         result.solved, result.latency.mean());
+            if (result.nodes >= 0)
+                std::fprintf(out, "\"nodes_per_call\": %.2f, ", perCall(result, static_cast<double>(result.nodes)));
+            else
+                std::fprintf(out, "\"nodes_per_call\": null, ");
+            std::fprintf(out, "\"p50_ns\": %llu, \"p90_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu}",
+                         static_cast<unsigned long long>(result.latency.percentile(0.50)),
+                         static_cast<unsigned long long>(result.latency.percentile(0.90)),
+                         static_cast<unsigned long long>(result.latency.percentile(0.99)),
+                         static_cast<unsigned long long>(result.latency.max()));
+        }
+        std::fprintf(out, "\n  ]\n}\n");
+    }
+
+    void printLatency(const std::vector<LatencyResult> &results)
+    {
+        std::printf("%-10s %8s %10s %10s %10s %10s %10s %10s\n", "generate", "calls", "mean", "p50", "p90", "p99",
+                    "p99.9", "max");
+        for (const LatencyResult &result : results)
+        {
+            const SudokuHistogram &latency = result.latency;
+            std::printf("%-10s %8llu %10s %10s %10s %10s %10s %10s\n", result.name.c_str(),
+                        static_cast<unsigned long long>(latency.count()),
+                        SudokuHistogram::formatNanos(static_cast<uint64_t>(latency.mean())).c_str(),
+                        SudokuHistogram::formatNanos(latency.percentile(0.50)).c_str(),
+                        SudokuHistogram::formatNanos(latency.percentile(0.90)).c_str(),
+                        SudokuHistogram::formatNanos(latency.percentile(0.99)).c_str(),
+                        SudokuHistogram::formatNanos(latency.percentile(0.999)).c_str(),
+                        SudokuHistogram::formatNanos(latency.max()).c_str());
+        }
+        for (const LatencyResult &result : results)
+        {
+            std::printf("slowest %s seeds:", result.name.c_str());
+            for (const SlowCase &slow : result.slowest)
+            {
+                std::printf(" %u (%s, first %s)", slow.seed, SudokuHistogram::formatNanos(slow.nanos).c_str(),
+                            SudokuHistogram::formatNanos(slow.firstNanos).c_str());
+            }
+            std::printf("\n");
+        }
+    }
+
+    void writeLatencyJson(std::FILE *out, const Options &options, const std::vector<LatencyResult> &results)
+    {
+        std::fprintf(out, "{\n  \"latency\": %d,\n  \"seed\": %u,\n  \"difficulties\": [", options.latency,
+                     options.seed);
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const SudokuHistogram &latency = results[i].latency;
+            std::fprintf(out,
+                         "%s\n    {\"name\": \"%s\", \"calls\": %llu, \"mean_ns\": %.1f, \"p50_ns\": %llu, "
+                         "\"p90_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu, \"slowest\": [",
+                         i ? "," : "", results[i].name.c_str(), static_cast<unsigned long long>(latency.count()),
+                         latency.mean(), static_cast<unsigned long long>(latency.percentile(0.50)),
+                         static_cast<unsigned long long>(latency.percentile(0.90)),
+                         static_cast<unsigned long long>(latency.percentile(0.99)),
+                         static_cast<unsigned long long>(latency.percentile(0.999)),
+                         static_cast<unsigned long long>(latency.max()));
+            for (size_t j = 0; j < results[i].slowest.size(); j++)
+            {
+                const SlowCase &slow = results[i].slowest[j];
+                std::fprintf(out, "%s{\"seed\": %u, \"ns\": %llu, \"first_ns\": %llu}", j ? ", " : "", slow.seed,
+                             static_cast<unsigned long long>(slow.nanos),
+                             static_cast<unsigned long long>(slow.firstNanos));
+            }
+            std::fprintf(out, "]}");
+        }
+        std::fprintf(out, "\n  ]\n}\n");
+    }
+
+    // Print the table, or the JSON in its place for "--json -"; otherwise also
+    // write the JSON to the named file
+    template <typename Results>
+    int report(const Options &options, const Results &results, void (*print)(const Results &),
+               void (*writeJson)(std::FILE *, const Options &, const Results &))
+    {
+        if (options.jsonFile == "-")
+        {
+            writeJson(stdout, options, results);
+            return 0;
+        }
+        print(results);
+        if (!options.jsonFile.empty())
+        {
+            std::FILE *out = std::fopen(options.jsonFile.c_str(), "w");
+            if (!out)
+            {
+                std::fprintf(stderr, "Cannot write %s\n", options.jsonFile.c_str());
+                return 1;
+            }
+            writeJson(out, options, results);
+            std::fclose(out);
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        usage();
+        return 2;
+    }
+
+    if (options.latency > 0)
+    {
+        std::vector<LatencyResult> results;
+        results.push_back(runLatency("easy", Difficulty::EASY, options));
+        results.push_back(runLatency("medium", Difficulty::MEDIUM, options));
+        results.push_back(runLatency("hard", Difficulty::HARD, options));
+        return report(options, results, printLatency, writeLatencyJson);
+    }
+
+    const Call solve = [](SudokuBoard &board, SolverStats &stats) {
+        Contradiction contradiction;
+        return SudokuSolver::solve(board, contradiction, nullptr, &stats) == SolveResult::SOLVED;
+    };
+    const Call count = [](SudokuBoard &board, SolverStats &stats) {
+        return SudokuSolver::countSolutions(board, 2, &stats) == 1;
+    };
+    const Call advanced = [](SudokuBoard &board, SolverStats &) {
+        return SudokuAdvancedChecks::solveWithAdvancedTechniques(board);
+    };
+
+    std::vector<Result> results;
+    for (const char *corpus : CORPORA)
+    {
+        std::vector<SudokuBoard> puzzles;
+        std::string filename = options.dataDir + "/" + corpus + ".txt";
+        if (!loadCorpus(filename, puzzles))
+        {
+            std::fprintf(stderr, "Cannot read corpus %s\n", filename.c_str());
+            return 1;
+        }
+        results.push_back(runCorpus(std::string("solve/") + corpus, puzzles, options.rounds, solve, true));
+        results.push_back(runCorpus(std::string("count/") + corpus, puzzles, options.rounds, count, true));
+        results.push_back(runCorpus(std::string("advanced/") + corpus, puzzles, options.rounds, advanced, false));
+    }
+    if (!runGridCorpora<Geometry16>("16x16", options, results) || !runGridCorpora<Geometry25>("25x25", options, results) ||
+        !runGridCorpora<SamuraiGeometry>("samurai", options, results))
+    {
+        return 1;
+    }
+    if (options.generate > 0)
+    {
+        results.push_back(runGenerate("generate/easy", Difficulty::EASY, options));
+        results.push_back(runGenerate("generate/medium", Difficulty::MEDIUM, options));
+        results.push_back(runGenerate("generate/hard", Difficulty::HARD, options));
+    }
+
+    return report(options, results, printTable, writeJson);
+}
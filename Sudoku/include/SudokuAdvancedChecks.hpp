@@ -5,6 +5,29 @@
 #include <vector>
 #include <set>
 
+// Techniques known to the grader, in increasing order of difficulty
+enum class Technique {
+    NONE,
+    HIDDEN_SINGLE,
+    NAKED_SINGLE,
+    LOCKED_CANDIDATES,
+    NAKED_PAIR,
+    X_WING,
+    HIDDEN_PAIR,
+    NAKED_TRIPLE,
+    HIDDEN_TRIPLE,
+    SEARCH          // Needs trial and error beyond the techniques above
+};
+
+// Result of grading a puzzle
+struct PuzzleRating {
+    int score = 0;                      // Weight of the hardest technique needed
+    Technique hardest = Technique::NONE;
+    int steps = 0;                      // Technique applications
+    bool solved = false;                // Fully solved by techniques (implies a unique solution)
+    bool consistent = true;             // false if a contradiction was reached
+};
+
 class SudokuAdvancedChecks {
 public:
     // Advanced solving techniques
@@ -20,6 +43,17 @@ public:
     // Solve using advanced techniques (no backtracking)
     static bool solveWithAdvancedTechniques(SudokuBoard& board);
     
+    // Grade a puzzle by the hardest technique a human solver needs, always using the
+    // easiest technique available. Grading stops as soon as a technique heavier than
+    // ceiling would be required; the returned score is then above ceiling.
+    static PuzzleRating ratePuzzle(const SudokuBoard& board, int ceiling = 1000);
+
+    // Score weight of a technique (Sudoku Explainer scale x10)
+    static int techniqueScore(Technique technique);
+
+    // Short lower-case name of a technique
+    static const char* techniqueName(Technique technique);
+    
     // Get possible values for a cell
     static std::set<int> getPossibleValues(const SudokuBoard& board, int row, int col);
     
@@ -0,0 +1,66 @@
+#ifndef SUDOKU_BACKGROUND_SOLVER_HPP
+#define SUDOKU_BACKGROUND_SOLVER_HPP
+
+#include "SudokuBoard.hpp"
+#include "SudokuSolver.hpp"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// State of the precomputed solution
+enum class SolutionStatus
+{
+    NONE,       // Nothing started
+    PENDING,    // Solver still running
+    READY,      // Solution available
+    UNSOLVABLE  // Puzzle has no solution; see contradiction()
+};
+
+// Solves a puzzle on a worker thread so the UI can keep running. Once READY,
+// every query is a table lookup. Starting a new puzzle cancels the previous search.
+// Queries are made from the owning (UI) thread; only status() may change
+// underneath them, and it is published after the result is complete.
+class SudokuBackgroundSolver
+{
+public:
+    SudokuBackgroundSolver();
+    ~SudokuBackgroundSolver();
+
+    SudokuBackgroundSolver(const SudokuBackgroundSolver &) = delete;
+    SudokuBackgroundSolver &operator=(const SudokuBackgroundSolver &) = delete;
+
+    // Cancel any running search and start solving puzzle
+    void start(const SudokuBoard &puzzle);
+
+    // Cancel the running search and wait for the worker (bounded by one search node)
+    void cancel();
+
+    SolutionStatus status() const { return currentStatus.load(std::memory_order_acquire); }
+
+    // Solution digit at (row, col) once READY, otherwise 0
+    int value(int row, int col) const;
+
+    // True once READY if the solution is the only one
+    bool isUnique() const { return status() == SolutionStatus::READY && unique; }
+
+    // The solved grid once READY
+    bool solution(SudokuBoard &board) const;
+
+    // Why the puzzle failed once UNSOLVABLE
+    const Contradiction &contradiction() const { return failure; }
+
+private:
+    // Worker body
+    void solveInBackground(SudokuBoard puzzle);
+
+    std::thread worker;
+    std::atomic<bool> cancelRequested;
+    std::atomic<SolutionStatus> currentStatus;
+
+    // Written by the worker before status becomes READY or UNSOLVABLE
+    uint8_t cells[81];
+    bool unique;
+    Contradiction failure;
+};
+
+#endif // SUDOKU_BACKGROUND_SOLVER_HPP
@@ -0,0 +1,42 @@
+#ifndef SUDOKU_BATCH_SOLVER_HPP
+#define SUDOKU_BATCH_SOLVER_HPP
+
+#include <cstdint>
+
+// How a puzzle in a batch was settled
+enum class BatchResult : uint8_t
+{
+    PROPAGATED, // Solved by singles propagation in the SIMD lanes
+    SEARCHED,   // Needed branching; solved by SudokuSolver
+    UNSOLVABLE  // Contradiction found (or the scalar search failed)
+};
+
+// Counts of BatchResult values over a run
+struct BatchSolveStats
+{
+    long long propagated = 0;
+    long long searched = 0;
+    long long unsolvable = 0;
+};
+
+// Solves many puzzles at once. Puzzles are laid out structure-of-arrays, one per
+// lane: candidate masks are stored as [cell][lane] so every step of naked- and
+// hidden-single propagation is the same bitwise operation across LANES puzzles,
+// which the compiler turns into vector instructions. Lanes that stall without a
+// contradiction are handed to the scalar SudokuSolver.
+class SudokuBatchSolver
+{
+public:
+    static const int LANES = 16;
+
+    // puzzles and solutions hold count * 81 digits (0 = blank, row-major). Unsolvable
+    // puzzles are copied to solutions unchanged.
+    static void solve(const uint8_t *puzzles, int count, uint8_t *solutions, BatchResult *results,
+                      BatchSolveStats *stats = nullptr);
+
+private:
+    // Propagate up to LANES puzzles together and settle each one
+    static void solveLanes(const uint8_t *puzzles, int count, uint8_t *solutions, BatchResult *results);
+};
+
+#endif // SUDOKU_BATCH_SOLVER_HPP
@@ -0,0 +1,124 @@
+#ifndef SUDOKU_BITS_HPP
+#define SUDOKU_BITS_HPP
+
+#include <array>
+#include <cstdint>
+
+// SSE2 is baseline on x86-64; the vector paths fall back to scalar code elsewhere
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUDOKU_HAS_SSE2 1
+#endif
+
+// Bitmask helpers and cell/unit lookup tables shared by the mask-based engines.
+// Digit d (1-9) is bit (d - 1); cells are numbered row * 9 + col.
+namespace SudokuBits
+{
+    const int ALL_DIGITS = 0x1FF;
+
+    inline int popCount(unsigned mask)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcount(mask);
+#else
+        int count = 0;
+        for (; mask; mask &= mask - 1)
+        {
+            count++;
+        }
+        return count;
+#endif
+    }
+
+    // Index of the lowest set bit; mask must be non-zero
+    inline int lowestBit(unsigned mask)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz(mask);
+#else
+        int index = 0;
+        while (!(mask & 1u))
+        {
+            mask >>= 1;
+            index++;
+        }
+        return index;
+#endif
+    }
+
+    constexpr int rowOf(int cell) { return cell / 9; }
+    constexpr int colOf(int cell) { return cell % 9; }
+    constexpr int boxOf(int cell) { return (cell / 27) * 3 + (cell % 9) / 3; }
+
+    // Units 0-8 are rows, 9-17 columns, 18-26 boxes
+    constexpr std::array<std::array<uint8_t, 9>, 27> makeUnits()
+    {
+        std::array<std::array<uint8_t, 9>, 27> units{};
+        for (int i = 0; i < 9; i++)
+        {
+            for (int j = 0; j < 9; j++)
+            {
+                units[i][j] = static_cast<uint8_t>(i * 9 + j);
+                units[9 + i][j] = static_cast<uint8_t>(j * 9 + i);
+                units[18 + i][j] = static_cast<uint8_t>(((i / 3) * 3 + j / 3) * 9 + (i % 3) * 3 + j % 3);
+            }
+        }
+        return units;
+    }
+
+    // The 20 cells sharing a row, column or box with each cell
+    constexpr std::array<std::array<uint8_t, 20>, 81> makePeers()
+    {
+        std::array<std::array<uint8_t, 20>, 81> peers{};
+        for (int cell = 0; cell < 81; cell++)
+        {
+            int count = 0;
+            for (int other = 0; other < 81; other++)
+            {
+                if (other != cell &&
+                    (rowOf(other) == rowOf(cell) || colOf(other) == colOf(cell) || boxOf(other) == boxOf(cell)))
+                {
+                    peers[cell][count++] = static_cast<uint8_t>(other);
+                }
+            }
+        }
+        return peers;
+    }
+
+    inline constexpr std::array<std::array<uint8_t, 9>, 27> UNITS = makeUnits();
+    inline constexpr std::array<std::array<uint8_t, 20>, 81> PEERS = makePeers();
+
+    // Digits used in each row, column and box, updated move by move instead of
+    // rescanning the board
+    struct UnitMasks
+    {
+        uint16_t rows[9] = {};
+        uint16_t cols[9] = {};
+        uint16_t boxes[9] = {};
+
+        void clear() { *this = UnitMasks{}; }
+
+        void place(int cell, int digit)
+        {
+            uint16_t bit = static_cast<uint16_t>(1u << (digit - 1));
+            rows[rowOf(cell)] |= bit;
+            cols[colOf(cell)] |= bit;
+            boxes[boxOf(cell)] |= bit;
+        }
+
+        void remove(int cell, int digit)
+        {
+            uint16_t keep = static_cast<uint16_t>(~(1u << (digit - 1)));
+            rows[rowOf(cell)] &= keep;
+            cols[colOf(cell)] &= keep;
+            boxes[boxOf(cell)] &= keep;
+        }
+
+        // Digits that could still go in cell
+        unsigned candidates(int cell) const
+        {
+            return ~(rows[rowOf(cell)] | cols[colOf(cell)] | boxes[boxOf(cell)]) & ALL_DIGITS;
+        }
+    };
+}
+
+#endif // SUDOKU_BITS_HPP
@@ -13,6 +13,10 @@ private:
     std::vector<std::vector<int>> board;
 
 public:
+    // Sizes of the compact binary encodings
+    static const int PACKED_SIZE = 41;    // 4 bits per cell, low nibble first
+    static const int CLUE_MASK_SIZE = 11; // 1 bit per cell, relative to a known solution
+
     // Constructor
     SudokuBoard();
 
@@ -32,6 +36,22 @@ public:
     bool loadFromFile(const std::string &filename);
     bool saveToFile(const std::string &filename) const;
 
+    // Write the board as one 81-character line ('.' for blanks, no terminator)
+    void formatLine(char *line) const;
+
+    // Compact binary encodings
+    void encodePacked(unsigned char *packed) const;
+    bool decodePacked(const unsigned char *packed); // false if a nibble is above 9
+
+    // Raw forms of the packed encoding over 81 digits (row-major), for bulk scans
+    static void packCells(const unsigned char *cells, unsigned char *packed);
+    static bool unpackCells(const unsigned char *packed, unsigned char *cells);
+
+    // Clue mask against a solution: bit i is set when cell i (row * 9 + col) is given.
+    // Encoding fails if a given digit disagrees with the solution.
+    bool encodeClueMask(const SudokuBoard &solution, unsigned char *mask) const;
+    void decodeClueMask(const SudokuBoard &solution, const unsigned char *mask);
+
     // Utility
     bool isFull() const;
     void clear();
@@ -0,0 +1,100 @@
+#ifndef SUDOKU_CLI_HPP
+#define SUDOKU_CLI_HPP
+
+#include "SudokuBoard.hpp"
+#include "SudokuGenerator.hpp"
+#include "SudokuPipeline.hpp"
+#include <cstdio>
+#include <string>
+
+// Non-interactive front end. Each subcommand streams 81-character puzzle lines
+// from a file or stdin to a file or stdout and reports throughput on stderr:
+//   solve     solved grid per puzzle
+//   generate  new puzzles (optionally rated, symmetric, or written to a puzzle bank)
+//   rate      grader score and hardest technique per puzzle
+//   validate  whether each grid breaks a rule and whether it is complete
+//   count     number of solutions per puzzle, up to a limit
+//   serve     multi-session game server on a Unix-domain socket
+//   service   solve/generate/rate service on a Unix-domain socket or localhost TCP
+//   loadtest  closed-loop load generator for the service, with latency percentiles
+// solve, generate, validate and count also take --box RxC for grids other than
+// 9x9 (one character per cell, 1-9 then A, B, ... for 10 and up), or --variant
+// for 9x9 with extra rules (diagonals, Windoku windows, anti-knight, anti-king,
+// Killer cages, whose lines carry the cages after the 81 cells, the jigsaw
+// regions of a --layout file, or the five overlapping grids of a Samurai).
+class SudokuCli
+{
+private:
+    struct Options
+    {
+        std::string command;
+        std::string input;  // Empty for stdin
+        std::string output; // Empty for stdout
+        std::string bank;   // generate: also write a puzzle bank here; serve, service: draw puzzles from it
+        std::string socket;            // Empty for the command's default
+        std::string request = "solve"; // loadtest: solve, rate or generate
+        long long sessions = 1 << 20;  // serve: session limit
+        int port = 0;                  // service, loadtest: localhost TCP port
+        int batch = 64;                // service: requests per worker batch
+        int buffer = 0;                // serve, service: pre-generated puzzles per difficulty
+        long long count = 1;
+        Difficulty difficulty = Difficulty::MEDIUM;
+        Symmetry symmetry = Symmetry::NONE;
+        bool rated = false;
+        bool quiet = false;
+        unsigned int seed = 0;
+        int limit = 2;
+        int boxRows = 3; // --box: box height and width, so grids are (rows * cols) square
+        int boxCols = 3;
+        std::string variant; // --variant: x, windoku, antiknight, antiking, killer, jigsaw or samurai, or empty
+        std::string layout;  // --layout: jigsaw region layout file
+        int threads = 1; // More than 1 (or 0 = all cores) runs through SudokuPipeline
+    };
+
+    // Line handler: fills out (without newline) and returns its length. With several
+    // threads it runs concurrently, so shared counters must be atomic.
+    using LineHandler = SudokuPipeline::Handler;
+
+    static bool parseOptions(int argc, char *argv[], Options &options);
+    static void printUsage();
+
+    // Open the output with a large buffer; nullptr on failure
+    static std::FILE *openOutput(const Options &options);
+
+    // Run handler over every puzzle of the input; returns the number of puzzles or -1
+    static long long streamPuzzles(const Options &options, std::FILE *out, const LineHandler &handler);
+
+    // Same, handing whole batches of puzzles to handler
+    static long long streamBatches(const Options &options, std::FILE *out,
+                                   const SudokuPipeline::BatchHandler &handler);
+
+    static int runSolve(const Options &options);
+    static int runGenerate(const Options &options);
+    static int runRate(const Options &options);
+    static int runValidate(const Options &options);
+    static int runCount(const Options &options);
+    static int runServe(const Options &options);
+    static int runService(const Options &options);
+    static int runLoadtest(const Options &options);
+
+    // solve, generate, validate or count on a grid of another size or a variant,
+    // through the templated engine
+    static int runSized(const Options &options);
+    template <typename Geometry>
+    static int runGrid(const Options &options);
+
+    // solve, generate, validate or count on Killer puzzles (SudokuKiller's text form)
+    static int runKiller(const Options &options);
+
+    // Report puzzles processed and the rate on stderr
+    static void printStats(const Options &options, long long puzzles, double seconds, const std::string &extra);
+
+public:
+    // True if name is one of the subcommands
+    static bool isCommand(const std::string &name);
+
+    // Run a subcommand; argv[1] is the subcommand name. Returns the process exit code.
+    static int run(int argc, char *argv[]);
+};
+
+#endif // SUDOKU_CLI_HPP
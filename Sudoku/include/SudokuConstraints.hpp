@@ -0,0 +1,266 @@
+#ifndef SUDOKU_CONSTRAINTS_HPP
+#define SUDOKU_CONSTRAINTS_HPP
+
+#include "SudokuGrid.hpp"
+#include <algorithm>
+#include <string>
+
+// Variant rules as constraint policies. A policy adds either extra units (SIZE
+// cells that must hold every digit once, like a row) or a pairwise rule (two
+// cells that may not hold the same digit), and VariantGeometry folds any set of
+// them into the unit and peer tables of a base geometry at compile time. The
+// solver, generator and validator read nothing but those tables, so a variant
+// runs through exactly the same code, and costs the same per peer, as classic
+// Sudoku. Every policy provides all three hooks:
+//   unitCount<Base>()          extra units it adds
+//   unitCell<Base>(unit, i)    cell number of the i-th cell of one of them
+//   sees<Base>(a, b)           true if cells a and b may not share a digit
+//                              (beyond sharing a unit)
+
+// X-Sudoku: both main diagonals are units
+struct DiagonalUnits
+{
+    static constexpr const char *NAME = "diagonal";
+
+    template <typename Base>
+    static constexpr int unitCount() { return 2; }
+
+    template <typename Base>
+    static constexpr int unitCell(int unit, int index)
+    {
+        return index * Base::SIZE + (unit == 0 ? index : Base::SIZE - 1 - index);
+    }
+
+    template <typename Base>
+    static constexpr bool sees(int, int) { return false; }
+};
+
+// Windoku: box-shaped windows one cell in from each box corner, separated by a
+// line (the four shaded 3x3 windows on 9x9)
+struct WindowUnits
+{
+    static constexpr const char *NAME = "window";
+
+    template <typename Base>
+    static constexpr int down() { return (Base::SIZE - 1) / (Base::BOX_ROWS + 1); }
+
+    template <typename Base>
+    static constexpr int across() { return (Base::SIZE - 1) / (Base::BOX_COLS + 1); }
+
+    template <typename Base>
+    static constexpr int unitCount() { return down<Base>() * across<Base>(); }
+
+    template <typename Base>
+    static constexpr int unitCell(int unit, int index)
+    {
+        int row = 1 + (unit / across<Base>()) * (Base::BOX_ROWS + 1) + index / Base::BOX_COLS;
+        int col = 1 + (unit % across<Base>()) * (Base::BOX_COLS + 1) + index % Base::BOX_COLS;
+        return row * Base::SIZE + col;
+    }
+
+    template <typename Base>
+    static constexpr bool sees(int, int) { return false; }
+};
+
+// Anti-knight: cells a chess knight's move apart differ
+struct AntiKnight
+{
+    static constexpr const char *NAME = nullptr;
+
+    template <typename Base>
+    static constexpr int unitCount() { return 0; }
+
+    template <typename Base>
+    static constexpr int unitCell(int, int) { return 0; }
+
+    template <typename Base>
+    static constexpr bool sees(int a, int b)
+    {
+        int rows = Base::rowOf(a) > Base::rowOf(b) ? Base::rowOf(a) - Base::rowOf(b) : Base::rowOf(b) - Base::rowOf(a);
+        int cols = Base::colOf(a) > Base::colOf(b) ? Base::colOf(a) - Base::colOf(b) : Base::colOf(b) - Base::colOf(a);
+        return (rows == 1 && cols == 2) || (rows == 2 && cols == 1);
+    }
+};
+
+// Anti-king: cells that touch, even at a corner, differ
+struct AntiKing
+{
+    static constexpr const char *NAME = nullptr;
+
+    template <typename Base>
+    static constexpr int unitCount() { return 0; }
+
+    template <typename Base>
+    static constexpr int unitCell(int, int) { return 0; }
+
+    template <typename Base>
+    static constexpr bool sees(int a, int b)
+    {
+        int rows = Base::rowOf(a) - Base::rowOf(b);
+        int cols = Base::colOf(a) - Base::colOf(b);
+        return a != b && rows >= -1 && rows <= 1 && cols >= -1 && cols <= 1;
+    }
+};
+
+// The combined rules of a base geometry and a set of policies, as used to build
+// the tables of VariantGeometry
+template <typename Base, typename... Constraints>
+struct VariantRules
+{
+    static const int EXTRA_UNITS = (0 + ... + Constraints::template unitCount<Base>());
+
+    template <typename Constraint>
+    static constexpr bool sharesUnit(int a, int b)
+    {
+        for (int unit = 0; unit < Constraint::template unitCount<Base>(); unit++)
+        {
+            bool hasA = false;
+            bool hasB = false;
+            for (int i = 0; i < Base::SIZE; i++)
+            {
+                int cell = Constraint::template unitCell<Base>(unit, i);
+                hasA = hasA || cell == a;
+                hasB = hasB || cell == b;
+            }
+            if (hasA && hasB)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static constexpr bool isBasePeer(int a, int b)
+    {
+        return a != b && (Base::rowOf(a) == Base::rowOf(b) || Base::colOf(a) == Base::colOf(b) ||
+                          Base::boxOf(a) == Base::boxOf(b));
+    }
+
+    // Peers the policies add to those of the base geometry
+    static constexpr bool isExtraPeer(int a, int b)
+    {
+        return a != b && !isBasePeer(a, b) &&
+               ((false || ... || sharesUnit<Constraints>(a, b)) || (false || ... || Constraints::template sees<Base>(a, b)));
+    }
+
+    static constexpr int peerCount(int cell)
+    {
+        int count = Base::PEER_COUNT;
+        for (int other = 0; other < Base::CELLS; other++)
+        {
+            count += isExtraPeer(cell, other) ? 1 : 0;
+        }
+        return count;
+    }
+
+    static constexpr int maxPeerCount()
+    {
+        int most = 0;
+        for (int cell = 0; cell < Base::CELLS; cell++)
+        {
+            most = std::max(most, peerCount(cell));
+        }
+        return most;
+    }
+};
+
+// Base geometry plus constraint policies. Extra units follow the base units in
+// policy order. Every cell's peers are the base peers, then the added ones in
+// cell order; cells with fewer than PEER_COUNT peers repeat their first peer to
+// fill the row, which clearing a digit or checking a move treats as a no-op, so
+// the peer loops keep a fixed, compile-time length.
+template <typename Base, typename... Constraints>
+struct VariantGeometry : Base
+{
+    using Rules = VariantRules<Base, Constraints...>;
+    using Cell = typename Base::Cell;
+
+    static const int UNIT_COUNT = Base::UNIT_COUNT + Rules::EXTRA_UNITS;
+    static const int PEER_COUNT = Rules::maxPeerCount();
+
+    // Row and band shuffles would break the added rules
+    static const bool SHUFFLE_LINES = false;
+
+    using UnitTable = std::array<std::array<Cell, Base::SIZE>, UNIT_COUNT>;
+    using PeerTable = std::array<std::array<Cell, PEER_COUNT>, Base::CELLS>;
+
+    static constexpr UnitTable makeUnits()
+    {
+        UnitTable units{};
+        typename Base::UnitTable base = Base::makeUnits();
+        for (int unit = 0; unit < Base::UNIT_COUNT; unit++)
+        {
+            for (int i = 0; i < Base::SIZE; i++)
+            {
+                units[unit][i] = base[unit][i];
+            }
+        }
+        int next = Base::UNIT_COUNT;
+        (addUnits<Constraints>(units, next), ...);
+        return units;
+    }
+
+    static constexpr PeerTable makePeers()
+    {
+        PeerTable peers{};
+        typename Base::PeerTable base = Base::makePeers();
+        for (int cell = 0; cell < Base::CELLS; cell++)
+        {
+            int count = 0;
+            for (; count < Base::PEER_COUNT; count++)
+            {
+                peers[cell][count] = base[cell][count];
+            }
+            for (int other = 0; other < Base::CELLS; other++)
+            {
+                if (Rules::isExtraPeer(cell, other))
+                {
+                    peers[cell][count++] = static_cast<Cell>(other);
+                }
+            }
+            for (; count < PEER_COUNT; count++)
+            {
+                peers[cell][count] = peers[cell][0];
+            }
+        }
+        return peers;
+    }
+
+    // "row 3", "diagonal 2", "window 4" (1-based for display)
+    static std::string unitName(int unit)
+    {
+        if (unit < Base::UNIT_COUNT)
+        {
+            return Base::unitName(unit);
+        }
+        std::string name;
+        int first = Base::UNIT_COUNT;
+        ((name.empty() && unit < first + Constraints::template unitCount<Base>()
+              ? (void)(name = std::string(Constraints::NAME) + " " + std::to_string(unit - first + 1))
+              : (void)0,
+          first += Constraints::template unitCount<Base>()),
+         ...);
+        return name;
+    }
+
+private:
+    template <typename Constraint>
+    static constexpr void addUnits(UnitTable &units, int &next)
+    {
+        for (int unit = 0; unit < Constraint::template unitCount<Base>(); unit++, next++)
+        {
+            for (int i = 0; i < Base::SIZE; i++)
+            {
+                units[next][i] = static_cast<Cell>(Constraint::template unitCell<Base>(unit, i));
+            }
+        }
+    }
+};
+
+// The 9x9 variants the front ends know about
+using GeometryX = VariantGeometry<Geometry9, DiagonalUnits>;
+using GeometryWindoku = VariantGeometry<Geometry9, WindowUnits>;
+using GeometryAntiKnight = VariantGeometry<Geometry9, AntiKnight>;
+using GeometryAntiKing = VariantGeometry<Geometry9, AntiKing>;
+
+#endif // SUDOKU_CONSTRAINTS_HPP
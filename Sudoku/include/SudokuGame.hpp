@@ -1,7 +1,12 @@
 #ifndef SUDOKU_GAME_HPP
 #define SUDOKU_GAME_HPP
 
+#include "SudokuBackgroundSolver.hpp"
+#include "SudokuBits.hpp"
 #include "SudokuBoard.hpp"
+#include "SudokuJournal.hpp"
+#include "SudokuMoveHistory.hpp"
+#include "SudokuRenderer.hpp"
 #include <string>
 
 class SudokuGame
@@ -10,6 +15,19 @@ private:
     SudokuBoard board;
     bool gameRunning;
 
+    // Solution of the current puzzle, computed off the UI thread
+    SudokuBackgroundSolver solver;
+
+    // Move history, digits in use per unit, and the autosave journal
+    SudokuMoveHistory history;
+    SudokuBits::UnitMasks masks;
+    SudokuJournal journal;
+
+    // Terminal output of the board, repainting only changed cells where possible
+    SudokuRenderer renderer;
+
+    static const char *const JOURNAL_FILE;
+
     // Display the main menu
     void displayMenu();
 
@@ -22,6 +40,27 @@ private:
     // Automatically solve the puzzle
     void solveAutomatically();
 
+    // Reveal one cell (or point out a wrong entry) from the cached solution
+    void giveHint();
+
+    // Take back or reapply the latest move, or the whole batch it belongs to
+    void undoMove();
+    void redoMove();
+
+    // Change one cell through the history, masks and journal; a chained move joins
+    // the batch of the move before it
+    void applyMove(int row, int col, int value, bool chained = false);
+
+    // Put a recorded move back on the board (forward) or take it off, with the
+    // masks and the journal's undo or redo record
+    void stepMove(const Move &move, bool forward);
+
+    // Reset history, masks, solver and journal for the puzzle now on the board
+    void startPuzzle();
+
+    // Pick up the session from the journal after a restart
+    bool resumeFromJournal();
+
     // Load puzzle from file
     void loadPuzzleFromFile();
 
@@ -40,6 +79,19 @@ private:
     // Initialize a default puzzle
     void initializeDefaultPuzzle();
 
+    // Number of the Exit menu entry, which depends on the optional features
+    int exitOption() const;
+
+#ifdef BUILD_GENERATOR
+    // Generate a new puzzle of a chosen difficulty
+    void generateNewPuzzle();
+#endif
+
+#ifdef BUILD_ADVANCED
+    // Solve using logical techniques only
+    void solveWithAdvancedTechniques();
+#endif
+
 public:
     // Constructor
     SudokuGame();
@@ -2,7 +2,11 @@
 #define SUDOKU_GENERATOR_HPP
 
 #include "SudokuBoard.hpp"
+#include <array>
+#include <cstdint>
 #include <random>
+#include <string>
+#include <vector>
 
 enum class Difficulty
 {
@@ -11,35 +15,163 @@ enum class Difficulty
     HARD    // Remove ~60 cells
 };
 
+// Symmetry of the clue layout; clues are removed a whole orbit at a time
+enum class Symmetry
+{
+    NONE,
+    ROTATIONAL_180, // (r, c) ~ (8 - r, 8 - c)
+    ROTATIONAL_90,  // (r, c) ~ (c, 8 - r) ~ (8 - r, 8 - c) ~ (8 - c, r)
+    DIAGONAL,       // (r, c) ~ (c, r)
+    MIRROR          // (r, c) ~ (r, 8 - c)
+};
+
+// Where complete grids come from
+enum class GridSource
+{
+    TRANSFORM, // Randomly transform a seed grid from the pool (fast)
+    SEARCH     // Fill diagonal boxes and backtrack (covers the whole grid space)
+};
+
+// Inclusive range of grader scores (see SudokuAdvancedChecks::ratePuzzle)
+struct RatingBand
+{
+    int minScore;
+    int maxScore;
+};
+
+// Work spent by rated generation
+struct GenerationStats
+{
+    int attempts = 0;         // Complete grids dug out
+    int rejected = 0;         // Attempts thrown away for ending below the band
+    int abandoned = 0;        // Rejected part-way, once the band was out of reach
+    int ratings = 0;          // Grader runs
+    int uniquenessChecks = 0; // Search-based uniqueness checks
+};
+
+// Settings for the multi-threaded low-clue search
+struct MinimalSearchOptions
+{
+    int targetClues = 22;            // Collect minimal puzzles with at most this many clues
+    int maxResults = 1;              // Stop once this many puzzles reached the target
+    int threads = 0;                 // Worker threads (0 = hardware concurrency)
+    double timeBudgetSeconds = 1.0;  // Wall-clock budget for the whole search
+    int improvementSteps = 100;      // {-1,+1} clue swaps tried on each minimal puzzle
+    unsigned int seed = 0;           // Base seed for the workers (0 = draw from the generator)
+};
+
+// Outcome of a low-clue search
+struct MinimalSearchResult
+{
+    std::vector<SudokuBoard> puzzles;    // Minimal puzzles at or below the target
+    SudokuBoard best;                    // Lowest-clue minimal puzzle seen
+    int bestClues = 82;
+    long long minimalPuzzles = 0;        // Minimal puzzles produced
+    std::array<long long, 82> clueCounts{}; // How many minimal puzzles had each clue count
+    double elapsedSeconds = 0.0;
+};
+
 class SudokuGenerator
 {
 private:
+    using Grid = std::array<uint8_t, 81>;
+
     static std::mt19937 rng;
+    static GridSource gridSource;
+    static std::vector<Grid> seedGrids;
 
     // Fill a diagonal 3x3 box with random numbers
-    static void fillDiagonalBox(SudokuBoard &board, int row, int col);
+    static void fillDiagonalBox(SudokuBoard &board, int row, int col, std::mt19937 &random);
 
     // Fill a complete valid Sudoku board
     static bool fillBoard(SudokuBoard &board);
 
+    // Complete grid by backtracking search
+    static SudokuBoard generateBySearch(std::mt19937 &random);
+
+    // Overwrite board with a complete grid from the current grid source
+    static void generateComplete(SudokuBoard &board, std::mt19937 &random);
+
+    // The built-in seed pool, parsed once at startup
+    static std::vector<Grid> builtinSeedGrids();
+
+    // Overwrite board with a random symmetry transform of a seed grid
+    static void transformSeedGrid(SudokuBoard &board, std::mt19937 &random);
+
+    // Remove every clue that is not needed for uniqueness, in random order.
+    // puzzle must have a unique solution; returns the number of clues left.
+    static int reduceToMinimal(SudokuBoard &puzzle, std::mt19937 &random);
+
+    // Parse an 81-digit string into a grid, rejecting anything that is not a valid solution
+    static bool parseSeedGrid(const std::string &line, Grid &grid);
+
     // Remove cells while ensuring unique solution
-    static void removeCells(SudokuBoard &board, int cellsToRemove);
+    static void removeCells(SudokuBoard &board, int cellsToRemove, Symmetry symmetry, std::mt19937 &random);
 
     // Check if puzzle has unique solution
     static bool hasUniqueSolution(const SudokuBoard &board);
 
     // Count solutions (used for uniqueness check)
-    static int countSolutions(SudokuBoard board, int maxSolutions = 2);
+    static int countSolutions(const SudokuBoard &board, int maxSolutions = 2);
 
 public:
     // Generate a new Sudoku puzzle with specified difficulty
-    static SudokuBoard generatePuzzle(Difficulty difficulty = Difficulty::MEDIUM);
+    static SudokuBoard generatePuzzle(Difficulty difficulty = Difficulty::MEDIUM,
+                                      Symmetry symmetry = Symmetry::NONE);
+
+    // Generate a puzzle drawing only on the caller's random engine. Threads that each
+    // own an engine can call this concurrently, as long as nobody changes the grid
+    // source or the seed pool meanwhile.
+    static SudokuBoard generatePuzzle(Difficulty difficulty, std::mt19937 &random,
+                                      Symmetry symmetry = Symmetry::NONE);
+
+    // Grader score band that matches a difficulty
+    static RatingBand ratingBand(Difficulty difficulty);
+
+    // Complete grids tried for one puzzle by the difficulty form of generateRatedPuzzle
+    static const int RATED_ATTEMPTS = 5000;
 
-    // Generate a completely filled valid Sudoku board
+    // Generate a puzzle whose grader score lies in the difficulty's band. Returns
+    // false if no attempt within RATED_ATTEMPTS landed in the band.
+    static bool generateRatedPuzzle(Difficulty difficulty, SudokuBoard &puzzle, GenerationStats *stats = nullptr,
+                                    Symmetry symmetry = Symmetry::NONE);
+
+    // Generate a puzzle whose grader score lies in band. Returns false if no attempt
+    // within maxAttempts landed in the band.
+    static bool generateRatedPuzzle(const RatingBand &band, SudokuBoard &puzzle,
+                                    GenerationStats *stats = nullptr, int maxAttempts = 1000,
+                                    Symmetry symmetry = Symmetry::NONE);
+
+    // Generate a minimal puzzle: no clue can be removed without losing uniqueness
+    static SudokuBoard generateMinimal();
+
+    // Search for minimal puzzles with few clues on several threads within a time budget.
+    // Each worker digs minimal puzzles out of fresh grids (from the grid source,
+    // with a searched grid mixed in every few rounds) and improves them with
+    // {-1,+1} clue swaps.
+    static MinimalSearchResult searchLowClue(const MinimalSearchOptions &options);
+
+    // Generate a completely filled valid Sudoku board using the current grid source
     static SudokuBoard generateComplete();
 
+    // Generate a completely filled valid Sudoku board using the given grid source
+    static SudokuBoard generateComplete(GridSource source);
+
+    // Overwrite an existing board with a complete grid, reusing its storage
+    static void generateComplete(SudokuBoard &board);
+
+    // Select the grid source used by generateComplete() and generatePuzzle()
+    static void setGridSource(GridSource source);
+
+    // Replace the seed pool with grids read from a file (one 81-digit line per grid).
+    // Returns false and keeps the current pool if the file holds no valid grid.
+    static bool loadSeedGrids(const std::string &filename);
+
+    // Number of grids in the seed pool
+    static size_t seedGridCount();
+
     // Set seed for random number generator
     static void setSeed(unsigned int seed);
 };
 
-#endif // SUDOKU_GENERATOR_HPP
\ No newline at end of file
+#endif // SUDOKU_GENERATOR_HPP
@@ -0,0 +1,298 @@
+#ifndef SUDOKU_GRID_HPP
+#define SUDOKU_GRID_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+// Compile-time shape of a grid with BoxRows x BoxCols boxes: SIZE = BoxRows * BoxCols
+// digits, rows, columns and boxes. Digit d is bit (d - 1) of a Mask, which is the
+// narrowest word that holds SIZE bits; cells are numbered row * SIZE + col. Units
+// 0 to SIZE-1 are rows, then columns, then boxes (numbered left to right, top to
+// bottom), exactly as SudokuBits numbers them for 9x9.
+//
+// The engines reach a geometry only through these members and the two tables
+// below, so other shapes (SudokuSamurai.hpp) can supply their own: ROWS x COLS
+// is the area the cells are laid out on, cellAt maps a position to its cell (-1
+// off the board), rowOf / colOf map back, and unitsOf lists the units that
+// weigh on a cell when the solver picks where to branch.
+template <int BoxRows, int BoxCols>
+struct GridGeometry
+{
+    static_assert(BoxRows >= 1 && BoxCols >= 1 && BoxRows * BoxCols <= 32, "Digits must fit a 32-bit mask");
+
+    static const int BOX_ROWS = BoxRows;
+    static const int BOX_COLS = BoxCols;
+    static const int SIZE = BoxRows * BoxCols;
+    static const int ROWS = SIZE;
+    static const int COLS = SIZE;
+    static const int CELLS = SIZE * SIZE;
+    static const int UNIT_COUNT = 3 * SIZE;
+    static const int PEER_COUNT = 3 * (SIZE - 1) - (BoxRows - 1) - (BoxCols - 1);
+
+    // Shuffling rows within bands (and columns within stacks) keeps every unit intact
+    static const bool SHUFFLE_LINES = true;
+
+    using Mask = std::conditional_t<(SIZE <= 16), uint16_t, uint32_t>;
+    using Cell = std::conditional_t<(CELLS <= 256), uint8_t, uint16_t>;
+
+    static constexpr Mask ALL_DIGITS = static_cast<Mask>((uint64_t(1) << SIZE) - 1);
+
+    static constexpr int rowOf(int cell) { return cell / SIZE; }
+    static constexpr int colOf(int cell) { return cell % SIZE; }
+    static constexpr int boxOf(int cell) { return (rowOf(cell) / BoxRows) * BoxRows + colOf(cell) / BoxCols; }
+
+    static constexpr int cellAt(int row, int col)
+    {
+        return row >= 0 && row < SIZE && col >= 0 && col < SIZE ? row * SIZE + col : -1;
+    }
+
+    // The row, column and box units of cell
+    static constexpr std::array<int, 3> unitsOf(int cell)
+    {
+        return {rowOf(cell), SIZE + colOf(cell), 2 * SIZE + boxOf(cell)};
+    }
+
+    // Cell number of the index-th cell (row-major) of box
+    static constexpr int boxCell(int box, int index)
+    {
+        return ((box / BoxRows) * BoxRows + index / BoxCols) * SIZE + (box % BoxRows) * BoxCols + index % BoxCols;
+    }
+
+    using UnitTable = std::array<std::array<Cell, SIZE>, UNIT_COUNT>;
+    using PeerTable = std::array<std::array<Cell, PEER_COUNT>, CELLS>;
+
+    static constexpr UnitTable makeUnits()
+    {
+        UnitTable units{};
+        for (int i = 0; i < SIZE; i++)
+        {
+            for (int j = 0; j < SIZE; j++)
+            {
+                units[i][j] = static_cast<Cell>(i * SIZE + j);
+                units[SIZE + i][j] = static_cast<Cell>(j * SIZE + i);
+                units[2 * SIZE + i][j] = static_cast<Cell>(boxCell(i, j));
+            }
+        }
+        return units;
+    }
+
+    // The cells sharing a row, column or box with each cell: the row, then the
+    // column, then the rest of the box
+    static constexpr PeerTable makePeers()
+    {
+        PeerTable peers{};
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            int row = rowOf(cell);
+            int col = colOf(cell);
+            int count = 0;
+            for (int i = 0; i < SIZE; i++)
+            {
+                if (i != col)
+                {
+                    peers[cell][count++] = static_cast<Cell>(row * SIZE + i);
+                }
+            }
+            for (int i = 0; i < SIZE; i++)
+            {
+                if (i != row)
+                {
+                    peers[cell][count++] = static_cast<Cell>(i * SIZE + col);
+                }
+            }
+            for (int i = 0; i < SIZE; i++)
+            {
+                int other = boxCell(boxOf(cell), i);
+                if (rowOf(other) != row && colOf(other) != col)
+                {
+                    peers[cell][count++] = static_cast<Cell>(other);
+                }
+            }
+        }
+        return peers;
+    }
+
+    // "row 3", "column 7", "box 1" (1-based for display)
+    static std::string unitName(int unit)
+    {
+        static const char *const kinds[] = {"row ", "column ", "box "};
+        return kinds[unit / SIZE] + std::to_string(unit % SIZE + 1);
+    }
+};
+
+// The tables live outside the struct because a static constexpr member cannot be
+// initialised by a member function of its own (still incomplete) class
+template <typename Geometry>
+inline constexpr typename Geometry::UnitTable GRID_UNITS = Geometry::makeUnits();
+
+template <typename Geometry>
+inline constexpr typename Geometry::PeerTable GRID_PEERS = Geometry::makePeers();
+
+// A grid of any geometry: one byte per cell, 0 for blank. The text form is one
+// character per cell, row-major: '.' or '0' for a blank, '1'-'9' and then 'A',
+// 'B', ... for 10 and up (so 16x16 uses 1-9 and A-G).
+template <typename Geometry>
+class SudokuGrid
+{
+public:
+    static const int SIZE = Geometry::SIZE;
+    static const int CELLS = Geometry::CELLS;
+
+    SudokuGrid() : cells() {}
+
+    // Value at (row, col), or -1 for a position off the grid
+    int getValue(int row, int col) const
+    {
+        int cell = Geometry::cellAt(row, col);
+        return cell >= 0 ? cells[cell] : -1;
+    }
+
+    // Set (row, col) to value (0 clears it); false if out of range
+    bool setValue(int row, int col, int value)
+    {
+        int cell = Geometry::cellAt(row, col);
+        if (cell < 0 || value < 0 || value > SIZE)
+        {
+            return false;
+        }
+        cells[cell] = static_cast<uint8_t>(value);
+        return true;
+    }
+
+    bool isEmpty(int row, int col) const { return getValue(row, col) == 0; }
+
+    // True if value does not already appear among the peers of (row, col)
+    bool isValidMove(int row, int col, int value) const
+    {
+        int cell = Geometry::cellAt(row, col);
+        if (cell < 0 || value < 1 || value > SIZE)
+        {
+            return false;
+        }
+        for (int peer : GRID_PEERS<Geometry>[cell])
+        {
+            if (cells[peer] == value)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isFull() const
+    {
+        for (uint8_t value : cells)
+        {
+            if (value == 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void clear() { cells.fill(0); }
+
+    // Raw cells, row-major
+    uint8_t *data() { return cells.data(); }
+    const uint8_t *data() const { return cells.data(); }
+
+    // Read exactly CELLS characters of the text form; false (grid unchanged) if malformed
+    bool parse(const char *line, size_t length)
+    {
+        if (length != static_cast<size_t>(CELLS))
+        {
+            return false;
+        }
+        std::array<uint8_t, CELLS> parsed;
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            int value = digitValue(line[cell]);
+            if (value < 0)
+            {
+                return false;
+            }
+            parsed[cell] = static_cast<uint8_t>(value);
+        }
+        cells = parsed;
+        return true;
+    }
+
+    // Write the text form (CELLS characters, no terminator)
+    void format(char *line) const
+    {
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            line[cell] = digitChar(cells[cell]);
+        }
+    }
+
+    // Boxed layout like SudokuBoard::printBoard; positions off the board stay blank
+    void print(std::ostream &out) const
+    {
+        const int rows = Geometry::ROWS;
+        const int cols = Geometry::COLS;
+        int width = 2 * cols + 2 * (cols / Geometry::BOX_COLS - 1) - 1;
+        std::string rule(static_cast<size_t>(width), '-');
+        std::string text = rule + "\n";
+        for (int row = 0; row < rows; row++)
+        {
+            for (int col = 0; col < cols; col++)
+            {
+                int cell = Geometry::cellAt(row, col);
+                text += cell >= 0 ? digitChar(cells[cell]) : ' ';
+                text += col == cols - 1 ? '\n' : ' ';
+                if (col % Geometry::BOX_COLS == Geometry::BOX_COLS - 1 && col != cols - 1)
+                {
+                    text += "| ";
+                }
+            }
+            if (row % Geometry::BOX_ROWS == Geometry::BOX_ROWS - 1)
+            {
+                text += rule + "\n";
+            }
+        }
+        out << text;
+    }
+
+    static char digitChar(int value)
+    {
+        if (value <= 0 || value > SIZE)
+        {
+            return '.';
+        }
+        return value < 10 ? static_cast<char>('0' + value) : static_cast<char>('A' + value - 10);
+    }
+
+    // Digit for a text character (0 for a blank), or -1 if it is not valid for this size
+    static int digitValue(char c)
+    {
+        int value = -1;
+        if (c == '.' || c == '0')
+            value = 0;
+        else if (c >= '1' && c <= '9')
+            value = c - '0';
+        else if (c >= 'A' && c <= 'Z')
+            value = c - 'A' + 10;
+        else if (c >= 'a' && c <= 'z')
+            value = c - 'a' + 10;
+        return value <= SIZE ? value : -1;
+    }
+
+private:
+    std::array<uint8_t, CELLS> cells;
+};
+
+// The sizes the front ends know about
+using Geometry4 = GridGeometry<2, 2>;
+using Geometry6 = GridGeometry<2, 3>;
+using Geometry9 = GridGeometry<3, 3>;
+using Geometry12 = GridGeometry<3, 4>;
+using Geometry16 = GridGeometry<4, 4>;
+using Geometry25 = GridGeometry<5, 5>;
+
+#endif // SUDOKU_GRID_HPP
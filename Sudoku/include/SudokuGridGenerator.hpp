@@ -0,0 +1,169 @@
+#ifndef SUDOKU_GRID_GENERATOR_HPP
+#define SUDOKU_GRID_GENERATOR_HPP
+
+#include "SudokuGenerator.hpp"
+#include "SudokuGridSolver.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+// Puzzle generation for any GridGeometry, along the lines of SudokuGenerator's
+// transform source: one solved grid per geometry, randomly relabelled and
+// shuffled by rows, bands, columns and stacks, then dug out cell by cell while
+// the solution stays unique. Variant geometries, whose rules line shuffles
+// would break, get each solved grid from a search seeded with random digits.
+template <typename Geometry>
+class SudokuGridGenerator
+{
+public:
+    using Grid = SudokuGrid<Geometry>;
+
+    static const int SIZE = Geometry::SIZE;
+    static const int CELLS = Geometry::CELLS;
+
+    // A random complete grid
+    static Grid generateComplete(std::mt19937 &random)
+    {
+        if (!Geometry::SHUFFLE_LINES)
+        {
+            return randomSolved(random);
+        }
+
+        static const Grid seed = solvedSeed();
+        const int bandRows = Geometry::BOX_ROWS;
+        const int stackCols = Geometry::BOX_COLS;
+
+        std::array<int, SIZE + 1> digits;
+        std::iota(digits.begin(), digits.end(), 0);
+        std::shuffle(digits.begin() + 1, digits.end(), random);
+
+        // Any order of bands, and of rows within a band, keeps every unit intact
+        std::array<int, SIZE> rows = shuffledLines(SIZE / bandRows, bandRows, random);
+        std::array<int, SIZE> cols = shuffledLines(SIZE / stackCols, stackCols, random);
+        bool transpose = bandRows == stackCols && (random() & 1);
+
+        Grid grid;
+        uint8_t *cells = grid.data();
+        for (int row = 0; row < SIZE; row++)
+        {
+            for (int col = 0; col < SIZE; col++)
+            {
+                int from = transpose ? cols[col] * SIZE + rows[row] : rows[row] * SIZE + cols[col];
+                cells[row * SIZE + col] = static_cast<uint8_t>(digits[seed.data()[from]]);
+            }
+        }
+        return grid;
+    }
+
+    // A puzzle with a unique solution and about the difficulty's share of blanks
+    // (fewer if no further cell can go without losing uniqueness, or without a
+    // uniqueness check that finishes within UNIQUENESS_NODES)
+    static Grid generatePuzzle(Difficulty difficulty, std::mt19937 &random)
+    {
+        Grid puzzle = generateComplete(random);
+        int target = CELLS * blankPercent(difficulty) / 100;
+
+        std::array<int, CELLS> order;
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), random);
+
+        int blanks = 0;
+        for (int cell : order)
+        {
+            if (blanks == target)
+            {
+                break;
+            }
+            int row = Geometry::rowOf(cell);
+            int col = Geometry::colOf(cell);
+            int value = puzzle.getValue(row, col);
+            puzzle.setValue(row, col, 0);
+            if (SudokuGridSolver<Geometry>::hasSolutionWithout(puzzle, row, col, value, UNIQUENESS_NODES))
+            {
+                puzzle.setValue(row, col, value);
+            }
+            else
+            {
+                blanks++;
+            }
+        }
+        return puzzle;
+    }
+
+    // Share of cells removed per difficulty, as SudokuGenerator removes 40, 50
+    // and 60 of 81 cells
+    static int blankPercent(Difficulty difficulty)
+    {
+        switch (difficulty)
+        {
+        case Difficulty::EASY:
+            return 49;
+        case Difficulty::MEDIUM:
+            return 62;
+        case Difficulty::HARD:
+            return 74;
+        }
+        return 62;
+    }
+
+private:
+    // Search budget for each uniqueness check while digging; a clue whose check
+    // runs out stays, which keeps 25x25 digging bounded and its puzzles solvable
+    // by a short search
+    static const long long UNIQUENESS_NODES = 200;
+
+    static Grid solvedSeed()
+    {
+        Grid grid;
+        SudokuGridSolver<Geometry>::solve(grid);
+        return grid;
+    }
+
+    // Scatter SIZE / 2 random digits wherever they fit and solve from there, starting
+    // over when the digits admit no solution or the search cannot find one quickly.
+    // Filling an empty grid takes about a node per cell, so the budget grows with it.
+    static Grid randomSolved(std::mt19937 &random)
+    {
+        std::uniform_int_distribution<int> anyCell(0, CELLS - 1);
+        std::uniform_int_distribution<int> anyDigit(1, SIZE);
+        for (;;)
+        {
+            Grid grid;
+            for (int placed = 0; placed < SIZE / 2;)
+            {
+                int cell = anyCell(random);
+                int digit = anyDigit(random);
+                int row = Geometry::rowOf(cell);
+                int col = Geometry::colOf(cell);
+                if (grid.isEmpty(row, col) && grid.isValidMove(row, col, digit))
+                {
+                    grid.setValue(row, col, digit);
+                    placed++;
+                }
+            }
+            if (SudokuGridSolver<Geometry>::solveWithin(grid, UNIQUENESS_NODES + CELLS))
+            {
+                return grid;
+            }
+        }
+    }
+
+    // Line order that shuffles groups of groupSize lines and the lines within each group
+    static std::array<int, SIZE> shuffledLines(int groups, int groupSize, std::mt19937 &random)
+    {
+        std::array<int, SIZE> groupOrder{};
+        std::iota(groupOrder.begin(), groupOrder.begin() + groups, 0);
+        std::shuffle(groupOrder.begin(), groupOrder.begin() + groups, random);
+
+        std::array<int, SIZE> lines{};
+        for (int group = 0; group < groups; group++)
+        {
+            int *first = lines.data() + group * groupSize;
+            std::iota(first, first + groupSize, groupOrder[group] * groupSize);
+            std::shuffle(first, first + groupSize, random);
+        }
+        return lines;
+    }
+};
+
+#endif // SUDOKU_GRID_GENERATOR_HPP
@@ -0,0 +1,1158 @@
+#ifndef SUDOKU_GRID_SOLVER_HPP
+#define SUDOKU_GRID_SOLVER_HPP
+
+#include "SudokuBits.hpp"
+#include "SudokuGrid.hpp"
+#include "SudokuSolver.hpp"
+#include <algorithm>
+#include <atomic>
+
+// Constraint propagation and search for any GridGeometry. This is the engine of
+// SudokuSolver written once over the geometry's tables: naked and hidden singles
+// to a fixed point, then depth-first search on the narrowest choice, either the
+// cell with the fewest candidates or the digit with the fewest places in a unit.
+// From 12x12 up, and on Samurai, propagation also applies locked candidates,
+// which is what keeps 16x16, 25x25 and Samurai searches small, and there it is
+// incremental: after a branch, each pass rechecks only the units holding a cell
+// that lost a candidate, and only the crossings of those. Every size and
+// loop bound is a compile-time constant, so each geometry is compiled
+// separately and no inner loop checks the grid size at run time. Variants
+// (SudokuConstraints.hpp) only bring longer tables: extra units join the
+// hidden-single and branching scans, and pairwise rules are extra peers. Rules
+// that depend on the puzzle, like Killer cages, come in as a propagation step.
+
+// Propagation step for rules beyond the geometry's tables, run once singles (and
+// locked candidates) stall, including on a full grid so it can reject one. It
+// narrows state.candidates of cells not yet placed, pushes every cell it brings
+// down to one candidate onto stack, sets progress if it removed anything, and
+// returns false on a contradiction after filling in *failure if given.
+// BRANCH_ON_DIGITS lets the search branch on a digit's places in a unit as well
+// as on a cell's candidates. This step adds no rules.
+struct NoPropagationStep
+{
+    static const bool BRANCH_ON_DIGITS = true;
+
+    template <typename State, typename Cell, typename Failure>
+    bool operator()(State &, Cell *, int &, bool &, Failure *) const
+    {
+        return true;
+    }
+};
+
+// Pairs of units that share more than one cell, for locked candidates: on a
+// single grid, each box with the rows and columns through it; on Samurai also
+// the boxes and lines that meet across grids. inFirst and inSecond mark, by
+// position within each unit, the cells the two share.
+template <typename Geometry>
+struct UnitCrossings
+{
+    struct Crossing
+    {
+        uint16_t first;
+        uint16_t second;
+        uint32_t inFirst;
+        uint32_t inSecond;
+    };
+
+    static constexpr int UNITS = Geometry::UNIT_COUNT;
+    static constexpr int SIZE = Geometry::SIZE;
+
+    // Position of every cell in every unit, -1 where it is not in the unit
+    static constexpr std::array<std::array<int8_t, Geometry::CELLS>, UNITS> positions()
+    {
+        std::array<std::array<int8_t, Geometry::CELLS>, UNITS> at{};
+        for (int unit = 0; unit < UNITS; unit++)
+        {
+            for (int cell = 0; cell < Geometry::CELLS; cell++)
+            {
+                at[unit][cell] = -1;
+            }
+            for (int i = 0; i < SIZE; i++)
+            {
+                at[unit][GRID_UNITS<Geometry>[unit][i]] = static_cast<int8_t>(i);
+            }
+        }
+        return at;
+    }
+
+    // Crossing of units a and b, with inFirst empty unless they share two cells
+    static constexpr Crossing crossing(const std::array<std::array<int8_t, Geometry::CELLS>, UNITS> &at, int a, int b)
+    {
+        Crossing result{static_cast<uint16_t>(a), static_cast<uint16_t>(b), 0, 0};
+        int shared = 0;
+        for (int i = 0; i < SIZE; i++)
+        {
+            int j = at[b][GRID_UNITS<Geometry>[a][i]];
+            if (j >= 0)
+            {
+                result.inFirst |= 1u << i;
+                result.inSecond |= 1u << j;
+                shared++;
+            }
+        }
+        if (shared < 2)
+        {
+            result.inFirst = result.inSecond = 0;
+        }
+        return result;
+    }
+
+    static constexpr int count()
+    {
+        auto at = positions();
+        int total = 0;
+        for (int a = 0; a < UNITS; a++)
+        {
+            for (int b = a + 1; b < UNITS; b++)
+            {
+                total += crossing(at, a, b).inFirst != 0 ? 1 : 0;
+            }
+        }
+        return total;
+    }
+
+    static constexpr int COUNT = count();
+
+    using Table = std::array<Crossing, COUNT>;
+
+    static constexpr Table make()
+    {
+        auto at = positions();
+        Table table{};
+        int next = 0;
+        for (int a = 0; a < UNITS; a++)
+        {
+            for (int b = a + 1; b < UNITS; b++)
+            {
+                Crossing c = crossing(at, a, b);
+                if (c.inFirst != 0)
+                {
+                    table[next++] = c;
+                }
+            }
+        }
+        return table;
+    }
+};
+
+template <typename Geometry>
+inline constexpr typename UnitCrossings<Geometry>::Table UNIT_CROSSINGS = UnitCrossings<Geometry>::make();
+
+// Every unit that holds each cell (on Samurai up to five, with variants more),
+// so propagation can recheck just the units an elimination touched. Cells in
+// fewer than COUNT units repeat their first one, as the peer tables do.
+template <typename Geometry>
+struct CellUnits
+{
+    static constexpr std::array<int, Geometry::CELLS> counts()
+    {
+        std::array<int, Geometry::CELLS> count{};
+        for (int unit = 0; unit < Geometry::UNIT_COUNT; unit++)
+        {
+            for (int i = 0; i < Geometry::SIZE; i++)
+            {
+                count[GRID_UNITS<Geometry>[unit][i]]++;
+            }
+        }
+        return count;
+    }
+
+    static constexpr int maxCount()
+    {
+        auto count = counts();
+        int most = 0;
+        for (int cell = 0; cell < Geometry::CELLS; cell++)
+        {
+            most = std::max(most, count[cell]);
+        }
+        return most;
+    }
+
+    static constexpr int COUNT = maxCount();
+
+    using Table = std::array<std::array<uint16_t, COUNT>, Geometry::CELLS>;
+
+    static constexpr Table make()
+    {
+        Table table{};
+        std::array<int, Geometry::CELLS> filled{};
+        for (int unit = 0; unit < Geometry::UNIT_COUNT; unit++)
+        {
+            for (int i = 0; i < Geometry::SIZE; i++)
+            {
+                int cell = GRID_UNITS<Geometry>[unit][i];
+                table[cell][filled[cell]++] = static_cast<uint16_t>(unit);
+            }
+        }
+        for (int cell = 0; cell < Geometry::CELLS; cell++)
+        {
+            for (int i = filled[cell]; i < COUNT; i++)
+            {
+                table[cell][i] = table[cell][0];
+            }
+        }
+        return table;
+    }
+};
+
+template <typename Geometry>
+inline constexpr typename CellUnits<Geometry>::Table CELL_UNITS = CellUnits<Geometry>::make();
+
+// Whether every peer of every cell shares a unit with it, so that a digit comes
+// off all of a cell's peers through the cell's units; pairwise variant rules
+// (anti-knight and the like) make it false
+template <typename Geometry>
+constexpr bool peersShareUnits()
+{
+    std::array<int, Geometry::CELLS> mateOf{}; // Last cell (plus one) found sharing a unit with each
+    for (int cell = 0; cell < Geometry::CELLS; cell++)
+    {
+        for (int unit : CELL_UNITS<Geometry>[cell])
+        {
+            for (int mate : GRID_UNITS<Geometry>[unit])
+            {
+                mateOf[mate] = cell + 1;
+            }
+        }
+        for (int peer : GRID_PEERS<Geometry>[cell])
+        {
+            if (mateOf[peer] != cell + 1)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Geometry, typename Step = NoPropagationStep>
+class SudokuGridSolver
+{
+public:
+    using Grid = SudokuGrid<Geometry>;
+    using Mask = typename Geometry::Mask;
+    using Cell = typename Geometry::Cell;
+
+    static const int SIZE = Geometry::SIZE;
+    static const int CELLS = Geometry::CELLS;
+
+    // Solve in place; false (grid unchanged) if there is no solution
+    static bool solve(Grid &grid)
+    {
+        Contradiction contradiction;
+        return solve(grid, contradiction) == SolveResult::SOLVED;
+    }
+
+    // Same, with SudokuSolver's result codes: a contradiction among the givens or
+    // reached by propagation alone is reported with its cell, unit (numbered as
+    // GRID_UNITS) and digit, and a minimal set of givens that force it. The search
+    // polls cancel (if given) at every node and returns CANCELLED once it is set.
+    static SolveResult solve(Grid &grid, Contradiction &contradiction, const std::atomic<bool> *cancel = nullptr,
+                             SolverStats *stats = nullptr, const Step &step = Step())
+    {
+        // Every contradiction findContradiction reports makes propagation fail, so
+        // only a failing grid pays for the report
+        State state;
+        if (!load(grid, state) || !propagate(state, nullptr, step))
+        {
+            if (!findContradiction(grid, contradiction, step))
+            {
+                contradiction.result = SolveResult::NO_SOLUTION;
+            }
+            return contradiction.result;
+        }
+        int weights[Geometry::UNIT_COUNT];
+        std::fill(weights, weights + Geometry::UNIT_COUNT, 1);
+        Search search{1, 0, nullptr, cancel, 0, 0, false, 0, weights, &step, nullptr};
+        State solution;
+        search.solution = &solution;
+        runWithRestarts(state, search);
+        if (stats)
+        {
+            stats->nodes += search.nodes;
+        }
+
+        contradiction = Contradiction{};
+        if (search.found == 0)
+        {
+            contradiction.result = search.stopped ? SolveResult::CANCELLED : SolveResult::NO_SOLUTION;
+            return contradiction.result;
+        }
+        store(solution, grid);
+        return SolveResult::SOLVED;
+    }
+
+    // Solve in place unless that takes more than nodeLimit nodes; false (grid
+    // unchanged) if there is no solution or the search gave up
+    static bool solveWithin(Grid &grid, long long nodeLimit, const Step &step = Step())
+    {
+        State state;
+        if (!load(grid, state) || !propagate(state, nullptr, step))
+        {
+            return false;
+        }
+        int weights[Geometry::UNIT_COUNT];
+        std::fill(weights, weights + Geometry::UNIT_COUNT, 1);
+        Search search{1, 0, nullptr, nullptr, 0, nodeLimit, false, 0, weights, &step, nullptr};
+        State solution;
+        search.solution = &solution;
+        runWithRestarts(state, search);
+        if (search.found == 0)
+        {
+            return false;
+        }
+        store(solution, grid);
+        return true;
+    }
+
+    // Duplicate givens, or a contradiction reached by propagation alone
+    static bool findContradiction(const Grid &grid, Contradiction &contradiction, const Step &step = Step())
+    {
+        contradiction = Contradiction{};
+        std::array<uint8_t, CELLS> cells;
+        std::copy(grid.data(), grid.data() + CELLS, cells.begin());
+
+        for (int unit = 0; unit < Geometry::UNIT_COUNT; unit++)
+        {
+            int firstCell[SIZE + 1];
+            std::fill(firstCell, firstCell + SIZE + 1, -1);
+            for (int cell : GRID_UNITS<Geometry>[unit])
+            {
+                int digit = cells[cell];
+                if (digit > SIZE)
+                {
+                    contradiction.result = SolveResult::DUPLICATE_GIVEN; // Out of range
+                    return true;
+                }
+                if (digit == 0)
+                {
+                    continue;
+                }
+                if (firstCell[digit] >= 0)
+                {
+                    contradiction.result = SolveResult::DUPLICATE_GIVEN;
+                    contradiction.unit = unit;
+                    contradiction.digit = digit;
+                    contradiction.givens = {firstCell[digit], cell};
+                    return true;
+                }
+                firstCell[digit] = cell;
+            }
+        }
+
+        // Pairwise variant rules (anti-knight and the like) belong to no unit
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            for (int peer : GRID_PEERS<Geometry>[cell])
+            {
+                if (cells[cell] != 0 && cells[peer] == cells[cell])
+                {
+                    contradiction.result = SolveResult::DUPLICATE_GIVEN;
+                    contradiction.digit = cells[cell];
+                    contradiction.givens = {cell, peer};
+                    return true;
+                }
+            }
+        }
+
+        if (!propagationFails(cells.data(), nullptr, step))
+        {
+            return false;
+        }
+
+        // Drop every given propagation can do without
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            if (cells[cell] == 0)
+            {
+                continue;
+            }
+            uint8_t given = cells[cell];
+            cells[cell] = 0;
+            if (!propagationFails(cells.data(), nullptr, step))
+            {
+                cells[cell] = given;
+            }
+        }
+
+        Failure failure{SolveResult::NO_SOLUTION, -1, -1, 0};
+        propagationFails(cells.data(), &failure, step);
+        contradiction.result = failure.result;
+        contradiction.cell = failure.cell;
+        contradiction.unit = failure.unit;
+        contradiction.digit = failure.digit;
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            if (cells[cell] != 0)
+            {
+                contradiction.givens.push_back(cell);
+            }
+        }
+        return true;
+    }
+
+    // Number of solutions, counting no further than maxSolutions
+    static int countSolutions(const Grid &grid, int maxSolutions = 2, SolverStats *stats = nullptr,
+                              const Step &step = Step())
+    {
+        State state;
+        if (maxSolutions <= 0 || !load(grid, state) || !propagate(state, nullptr, step))
+        {
+            return 0;
+        }
+        int weights[Geometry::UNIT_COUNT];
+        std::fill(weights, weights + Geometry::UNIT_COUNT, 1);
+        Search search{maxSolutions, 0, nullptr, nullptr, 0, 0, false, 0, weights, &step, nullptr};
+        run(state, search);
+        if (stats)
+        {
+            stats->nodes += search.nodes;
+        }
+        return search.found;
+    }
+
+    // Uniqueness check against a known solution (CELLS digits): true, with the
+    // other solution in other, if the puzzle has a solution that differs from
+    // known. Each branch tries the known digit last, so a second solution usually
+    // turns up within a few nodes.
+    static bool findOtherSolution(const Grid &grid, const uint8_t *known, uint8_t *other,
+                                  SolverStats *stats = nullptr, const Step &step = Step())
+    {
+        State state;
+        if (!load(grid, state) || !propagate(state, nullptr, step))
+        {
+            return false;
+        }
+        int weights[Geometry::UNIT_COUNT];
+        std::fill(weights, weights + Geometry::UNIT_COUNT, 1);
+        State solution;
+        Search search{1, 0, &solution, nullptr, 0, 0, false, 0, weights, &step, known};
+        runWithRestarts(state, search);
+        if (stats)
+        {
+            stats->nodes += search.nodes;
+        }
+        if (search.found == 0)
+        {
+            return false;
+        }
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            other[cell] = static_cast<uint8_t>(SudokuBits::lowestBit(solution.candidates[cell]) + 1);
+        }
+        return true;
+    }
+
+    // True if the puzzle has a solution in which the empty cell (row, col) is not
+    // value: with value taken from the known solution, false means unique. A
+    // search that runs past nodeLimit (0 = no limit) also answers true, which is
+    // the safe side for a generator deciding whether a clue can go.
+    static bool hasSolutionWithout(const Grid &grid, int row, int col, int value, long long nodeLimit = 0,
+                                   const Step &step = Step())
+    {
+        State state;
+        int cell = Geometry::cellAt(row, col);
+        if (grid.getValue(row, col) != 0 || !load(grid, state))
+        {
+            return false;
+        }
+        state.candidates[cell] = static_cast<Mask>(state.candidates[cell] & ~(1u << (value - 1)));
+        if (state.candidates[cell] == 0 || !propagate(state, nullptr, step))
+        {
+            return false;
+        }
+        int weights[Geometry::UNIT_COUNT];
+        std::fill(weights, weights + Geometry::UNIT_COUNT, 1);
+        Search search{1, 0, nullptr, nullptr, 0, nodeLimit, false, 0, weights, &step, nullptr};
+        runWithRestarts(state, search);
+        return search.found > 0 || search.stopped;
+    }
+
+private:
+    // Candidate masks; placed cells have had their digit removed from every peer
+    struct State
+    {
+        Mask candidates[CELLS];
+        uint8_t placed[CELLS];
+        int remaining;
+    };
+
+    // Where propagation ran dry
+    struct Failure
+    {
+        SolveResult result;
+        int cell;
+        int unit;
+        int digit;
+    };
+
+    // One search: solutions wanted and found, where to keep the first, and when to stop early
+    struct Search
+    {
+        int limit;
+        int found;
+        State *solution;
+        const std::atomic<bool> *cancel;
+        long long nodes;
+        long long nodeLimit;
+        bool stopped;
+        uint32_t random;      // 0 scans cells in order; otherwise from a random cell
+        int *weights;         // Failures seen per unit, steering the choice of cell
+        const Step *step;
+        const uint8_t *avoid; // A solution that does not count, or nullptr
+    };
+
+    // Node budget of the first attempt when looking for one solution
+    static const long long RESTART_NODES = 100;
+
+    // Locked candidates pay for themselves once boxes are large, and on shapes of
+    // several grids, where they carry eliminations from one grid to the next; on
+    // small single grids singles alone are faster, as with SudokuSolver
+    static const bool LOCKED_CANDIDATES = SIZE >= 12 || Geometry::ROWS != SIZE;
+
+    // The same geometries track what changed, so that each pass rechecks only
+    // the units (and crossings) holding a cell that lost a candidate; on small
+    // single grids rescanning every unit costs less than the bookkeeping
+    static const bool INCREMENTAL = LOCKED_CANDIDATES;
+
+    static const int CELL_WORDS = (CELLS + 31) / 32;
+    static const int UNIT_WORDS = (Geometry::UNIT_COUNT + 31) / 32;
+
+    // What propagation has yet to look at: cells narrowed or placed since the
+    // last collect(), the units due a hidden-single scan, and those scanned
+    // since that are due a locked-candidates scan of their crossings
+    struct Changes
+    {
+        uint32_t cells[CELL_WORDS];
+        uint32_t singles[UNIT_WORDS];
+        uint32_t crossings[UNIT_WORDS];
+    };
+
+    static bool isSingle(unsigned mask) { return (mask & (mask - 1)) == 0; }
+
+    static bool hasBit(const uint32_t *bits, int index) { return (bits[index / 32] >> (index % 32)) & 1u; }
+
+    static void touch(Changes &changes, int cell)
+    {
+        if constexpr (INCREMENTAL)
+        {
+            changes.cells[cell / 32] |= 1u << (cell % 32);
+        }
+    }
+
+    // Every unit due both scans
+    static void touchAll(Changes &changes)
+    {
+        std::fill(changes.cells, changes.cells + CELL_WORDS, 0u);
+        for (int word = 0; word < UNIT_WORDS; word++)
+        {
+            int bits = std::min(32, Geometry::UNIT_COUNT - word * 32);
+            changes.singles[word] = changes.crossings[word] = bits == 32 ? ~0u : (1u << bits) - 1;
+        }
+    }
+
+    // Turn the touched cells into due units; without tracking every unit is due
+    static void collect(Changes &changes)
+    {
+        if constexpr (INCREMENTAL)
+        {
+            for (int word = 0; word < CELL_WORDS; word++)
+            {
+                for (uint32_t bits = changes.cells[word]; bits; bits &= bits - 1)
+                {
+                    for (int unit : CELL_UNITS<Geometry>[word * 32 + SudokuBits::lowestBit(bits)])
+                    {
+                        changes.singles[unit / 32] |= 1u << (unit % 32);
+                    }
+                }
+                changes.cells[word] = 0;
+            }
+        }
+        else
+        {
+            touchAll(changes);
+        }
+    }
+
+    static bool fail(Failure *failure, SolveResult result, int cell, int unit, int digit)
+    {
+        if (failure)
+        {
+            *failure = Failure{result, cell, unit, digit};
+        }
+        return false;
+    }
+
+    // Givens become single candidates, placed by the first propagation; false if
+    // a value is out of range
+    static bool load(const uint8_t *cells, State &state)
+    {
+        state.remaining = CELLS;
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            if (cells[cell] > SIZE)
+            {
+                return false;
+            }
+            state.candidates[cell] = cells[cell] ? static_cast<Mask>(1u << (cells[cell] - 1)) : Geometry::ALL_DIGITS;
+            state.placed[cell] = 0;
+        }
+        return true;
+    }
+
+    static bool load(const Grid &grid, State &state) { return load(grid.data(), state); }
+
+    static void store(const State &state, Grid &grid)
+    {
+        uint8_t *cells = grid.data();
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            cells[cell] = static_cast<uint8_t>(SudokuBits::lowestBit(state.candidates[cell]) + 1);
+        }
+    }
+
+    static bool propagationFails(const uint8_t *cells, Failure *failure, const Step &step)
+    {
+        State state;
+        return !load(cells, state) || !propagate(state, failure, step);
+    }
+
+    // Place every cell on the stack and strip its digit from the peers,
+    // following any new singles that creates
+    static bool placeCells(State &state, Cell *stack, int top, Changes &changes, Failure *failure)
+    {
+        while (top > 0)
+        {
+            int cell = stack[--top];
+            if (state.placed[cell])
+            {
+                continue;
+            }
+            state.placed[cell] = 1;
+            state.remaining--;
+            touch(changes, cell);
+
+            Mask bit = state.candidates[cell];
+            for (int peer : GRID_PEERS<Geometry>[cell])
+            {
+                if (!(state.candidates[peer] & bit))
+                {
+                    continue;
+                }
+                state.candidates[peer] ^= bit;
+                touch(changes, peer);
+                if (state.candidates[peer] == 0)
+                {
+                    return fail(failure, SolveResult::EMPTY_CELL, peer, -1, 0);
+                }
+                if (isSingle(state.candidates[peer]))
+                {
+                    stack[top++] = static_cast<Cell>(peer);
+                }
+            }
+        }
+        return true;
+    }
+
+    // Hidden singles in every unit due a scan, which are then due a locked-
+    // candidates scan instead; false on a contradiction
+    static bool hiddenSingles(State &state, Cell *stack, int &top, Changes &changes, Failure *failure)
+    {
+        for (int word = 0; word < UNIT_WORDS; word++)
+        {
+            for (uint32_t due = changes.singles[word]; due; due &= due - 1)
+            {
+                int unit = word * 32 + SudokuBits::lowestBit(due);
+                if (!hiddenSingles(state, unit, stack, top, changes, failure))
+                {
+                    return false;
+                }
+            }
+            changes.crossings[word] |= changes.singles[word];
+            changes.singles[word] = 0;
+        }
+        return true;
+    }
+
+    // Hidden singles in one unit
+    static bool hiddenSingles(State &state, int unit, Cell *stack, int &top, Changes &changes, Failure *failure)
+    {
+        unsigned once = 0;
+        unsigned twice = 0;
+        unsigned settled = 0; // Digits already down to one cell
+        for (int cell : GRID_UNITS<Geometry>[unit])
+        {
+            unsigned candidates = state.candidates[cell];
+            twice |= once & candidates;
+            once |= candidates;
+            settled |= isSingle(candidates) ? candidates : 0;
+        }
+        if (once != Geometry::ALL_DIGITS)
+        {
+            return fail(failure, SolveResult::MISSING_DIGIT, -1, unit,
+                        SudokuBits::lowestBit(~once & Geometry::ALL_DIGITS) + 1);
+        }
+
+        unsigned hidden = once & ~twice & ~settled;
+        if (!hidden)
+        {
+            return true;
+        }
+        for (int cell : GRID_UNITS<Geometry>[unit])
+        {
+            unsigned only = state.candidates[cell] & hidden;
+            if (only && !state.placed[cell] && !isSingle(state.candidates[cell]))
+            {
+                if (!isSingle(only))
+                {
+                    // Two digits that each fit only here
+                    return fail(failure, SolveResult::MISSING_DIGIT, -1, unit,
+                                SudokuBits::lowestBit(only & (only - 1)) + 1);
+                }
+                state.candidates[cell] = static_cast<Mask>(only);
+                touch(changes, cell);
+                stack[top++] = static_cast<Cell>(cell);
+            }
+        }
+        return true;
+    }
+
+    // Open candidates of unit at the positions marked in positions (inside) and
+    // at the rest (outside)
+    static void openSplit(const State &state, int unit, uint32_t positions, unsigned &inside, unsigned &outside)
+    {
+        inside = 0;
+        outside = 0;
+        for (int i = 0; i < SIZE; i++)
+        {
+            int cell = GRID_UNITS<Geometry>[unit][i];
+            unsigned open = state.placed[cell] ? 0u : state.candidates[cell];
+            unsigned in = 0u - ((positions >> i) & 1u); // Branch-free: the split differs between crossings
+            inside |= open & in;
+            outside |= open & ~in;
+        }
+    }
+
+    // Take digits out of the cells of unit outside positions; false if a cell
+    // runs out of candidates
+    static bool eliminateOutside(State &state, int unit, uint32_t positions, unsigned digits, Cell *stack, int &top,
+                                 Changes &changes, Failure *failure)
+    {
+        for (int i = 0; i < SIZE; i++)
+        {
+            int cell = GRID_UNITS<Geometry>[unit][i];
+            if (state.placed[cell] || !(state.candidates[cell] & digits) || ((positions >> i) & 1u))
+            {
+                continue;
+            }
+            state.candidates[cell] = static_cast<Mask>(state.candidates[cell] & ~digits);
+            touch(changes, cell);
+            if (state.candidates[cell] == 0)
+            {
+                return fail(failure, SolveResult::EMPTY_CELL, cell, -1, 0);
+            }
+            if (isSingle(state.candidates[cell]))
+            {
+                stack[top++] = static_cast<Cell>(cell);
+            }
+        }
+        return true;
+    }
+
+    // Where two units cross (a box and a line, or on Samurai two lines of
+    // overlapping grids): digits one holds only in the shared cells leave the
+    // rest of the other, which is pointing and claiming at once. Only crossings
+    // of a unit due a scan are looked at, and no unit is due one afterwards.
+    // Sets progress if anything was removed.
+    static bool lockedCandidates(State &state, Cell *stack, int &top, bool &progress, Changes &changes,
+                                 Failure *failure)
+    {
+        // Only geometries that use it build the table (Jigsaw's units are not constexpr)
+        if constexpr (LOCKED_CANDIDATES)
+        {
+            uint32_t due[UNIT_WORDS];
+            std::copy(changes.crossings, changes.crossings + UNIT_WORDS, due);
+            std::fill(changes.crossings, changes.crossings + UNIT_WORDS, 0u);
+            for (const auto &crossing : UNIT_CROSSINGS<Geometry>)
+            {
+                if (!hasBit(due, crossing.first) && !hasBit(due, crossing.second))
+                {
+                    continue;
+                }
+                unsigned shared;
+                unsigned restOfFirst;
+                openSplit(state, crossing.first, crossing.inFirst, shared, restOfFirst);
+                if (shared == 0)
+                {
+                    continue;
+                }
+                unsigned restOfSecond;
+                openSplit(state, crossing.second, crossing.inSecond, shared, restOfSecond); // Same shared cells
+
+                unsigned fromSecond = shared & ~restOfFirst & restOfSecond;
+                unsigned fromFirst = shared & ~restOfSecond & restOfFirst;
+                if (fromSecond && !eliminateOutside(state, crossing.second, crossing.inSecond, fromSecond, stack, top,
+                                                    changes, failure))
+                {
+                    return false;
+                }
+                if (fromFirst && !eliminateOutside(state, crossing.first, crossing.inFirst, fromFirst, stack, top,
+                                                   changes, failure))
+                {
+                    return false;
+                }
+                progress = progress || fromSecond || fromFirst;
+            }
+        }
+        return true;
+    }
+
+    // Put the singles of a state not yet propagated (the givens) on the stack.
+    // Where every peer shares a unit, they are placed here instead: each unit's
+    // givens make a mask that comes off its other cells at once, which on large
+    // grids costs far less than visiting every peer of every given. New singles
+    // that leaves go on the stack. False if two givens clash or a cell is empty.
+    static bool placeGivens(State &state, Cell *stack, int &top, Failure *failure)
+    {
+        // Only geometries that build CELL_UNITS can check their peers (Jigsaw's are not constexpr)
+        if constexpr (LOCKED_CANDIDATES)
+        {
+            if constexpr (peersShareUnits<Geometry>())
+            {
+                Mask given[Geometry::UNIT_COUNT];
+                for (int unit = 0; unit < Geometry::UNIT_COUNT; unit++)
+                {
+                    unsigned digits = 0;
+                    for (int cell : GRID_UNITS<Geometry>[unit])
+                    {
+                        unsigned candidates = state.candidates[cell];
+                        if (state.placed[cell] || !isSingle(candidates))
+                        {
+                            continue;
+                        }
+                        if (candidates & digits)
+                        {
+                            return fail(failure, SolveResult::EMPTY_CELL, cell, -1, 0);
+                        }
+                        digits |= candidates;
+                    }
+                    given[unit] = static_cast<Mask>(digits);
+                }
+
+                for (int cell = 0; cell < CELLS; cell++)
+                {
+                    unsigned candidates = state.candidates[cell];
+                    if (state.placed[cell])
+                    {
+                        continue;
+                    }
+                    if (isSingle(candidates))
+                    {
+                        if (candidates == 0)
+                        {
+                            return fail(failure, SolveResult::EMPTY_CELL, cell, -1, 0);
+                        }
+                        state.placed[cell] = 1;
+                        state.remaining--;
+                        continue;
+                    }
+                    for (int unit : CELL_UNITS<Geometry>[cell])
+                    {
+                        candidates &= ~given[unit];
+                    }
+                    state.candidates[cell] = static_cast<Mask>(candidates);
+                    if (candidates == 0)
+                    {
+                        return fail(failure, SolveResult::EMPTY_CELL, cell, -1, 0);
+                    }
+                    if (isSingle(candidates))
+                    {
+                        stack[top++] = static_cast<Cell>(cell);
+                    }
+                }
+                return true;
+            }
+        }
+
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            if (!state.placed[cell] && isSingle(state.candidates[cell]))
+            {
+                if (state.candidates[cell] == 0)
+                {
+                    return fail(failure, SolveResult::EMPTY_CELL, cell, -1, 0);
+                }
+                stack[top++] = static_cast<Cell>(cell);
+            }
+        }
+        return true;
+    }
+
+    // Singles (and on large grids locked candidates), then the step, to a fixed
+    // point; false on a contradiction. Every cell counts as changed.
+    static bool propagate(State &state, Failure *failure, const Step &step)
+    {
+        Cell stack[CELLS];
+        int top = 0;
+        if (!placeGivens(state, stack, top, failure))
+        {
+            return false;
+        }
+        Changes changes;
+        touchAll(changes);
+        return propagate(state, stack, top, changes, failure, step);
+    }
+
+    // The same after a propagated state has had one cell narrowed to a single
+    static bool propagate(State &state, int narrowed, Failure *failure, const Step &step)
+    {
+        Cell stack[CELLS];
+        stack[0] = static_cast<Cell>(narrowed);
+        Changes changes{};
+        touch(changes, narrowed);
+        return propagate(state, stack, 1, changes, failure, step);
+    }
+
+    static bool propagate(State &state, Cell *stack, int top, Changes &changes, Failure *failure, const Step &step)
+    {
+        for (;;)
+        {
+            if (!placeCells(state, stack, top, changes, failure))
+            {
+                return false;
+            }
+            top = 0;
+            collect(changes);
+            if (!hiddenSingles(state, stack, top, changes, failure))
+            {
+                return false;
+            }
+            if (top > 0)
+            {
+                continue;
+            }
+            bool progress = false;
+            if (LOCKED_CANDIDATES && state.remaining > 0)
+            {
+                if (!lockedCandidates(state, stack, top, progress, changes, failure))
+                {
+                    return false;
+                }
+                if (progress)
+                {
+                    continue;
+                }
+            }
+            if (!step(state, stack, top, progress, failure))
+            {
+                return false;
+            }
+            if (!progress)
+            {
+                return true;
+            }
+            // The step does not say which cells it narrowed
+            touchAll(changes);
+        }
+    }
+
+    // Look for one solution in attempts with doubling node budgets, each scanning
+    // from a different random cell, so that one bad early branch cannot trap the
+    // search in a huge dead subtree. An attempt that runs to completion (finding
+    // a solution or proving there is none) ends it; total work stays within
+    // twice that last attempt. Counting does not restart, as a solution found
+    // twice would be counted twice.
+    static void runWithRestarts(const State &state, Search &search)
+    {
+        uint32_t random = 0;
+        for (long long budget = RESTART_NODES;; budget *= 2)
+        {
+            Search attempt = search;
+            attempt.nodes = 0;
+            attempt.random = random;
+            long long left = search.nodeLimit > 0 ? search.nodeLimit - search.nodes : 0;
+            attempt.nodeLimit = left > 0 && left < budget ? left : budget;
+            run(state, attempt);
+
+            search.nodes += attempt.nodes;
+            search.found = attempt.found;
+            if (!attempt.stopped)
+            {
+                return;
+            }
+            if ((search.cancel && search.cancel->load(std::memory_order_relaxed)) ||
+                (search.nodeLimit > 0 && search.nodes >= search.nodeLimit))
+            {
+                search.stopped = true;
+                return;
+            }
+            random = random * 1664525u + 1013904223u;
+        }
+    }
+
+    // Narrow cell to bit, propagate and search below it
+    static void branch(const State &state, int cell, unsigned bit, Search &search)
+    {
+        State next = state;
+        next.candidates[cell] = static_cast<Mask>(bit);
+        Failure failure{SolveResult::NO_SOLUTION, -1, -1, 0};
+        if (propagate(next, cell, &failure, *search.step))
+        {
+            run(next, search);
+            return;
+        }
+        if (failure.unit >= 0)
+        {
+            search.weights[failure.unit]++;
+        }
+        else if (failure.cell >= 0)
+        {
+            for (int unit : Geometry::unitsOf(failure.cell))
+            {
+                search.weights[unit]++;
+            }
+        }
+    }
+
+    // Count solutions below a propagated state until the limit is reached,
+    // keeping the first one. Branches on whichever is narrower, as exact-cover
+    // solvers do: the cell with the fewest candidates, or the digit with the
+    // fewest places in some unit. With a solution to avoid, its digit goes last,
+    // and reaching it does not count.
+    static void run(const State &state, Search &search)
+    {
+        if (state.remaining == 0)
+        {
+            if (search.avoid && isAvoided(state, search.avoid))
+            {
+                return;
+            }
+            if (search.found == 0 && search.solution)
+            {
+                *search.solution = state;
+            }
+            search.found++;
+            return;
+        }
+        if (search.stopped)
+        {
+            return;
+        }
+        search.nodes++;
+        if ((search.nodeLimit > 0 && search.nodes > search.nodeLimit) ||
+            (search.cancel && search.cancel->load(std::memory_order_relaxed)))
+        {
+            search.stopped = true;
+            return;
+        }
+
+        int start = 0;
+        if (search.random != 0)
+        {
+            search.random ^= search.random << 13;
+            search.random ^= search.random >> 17;
+            search.random ^= search.random << 5;
+            start = static_cast<int>(search.random % CELLS);
+        }
+
+        int best = -1;
+        int bestCount = SIZE + 1;
+        int bestWeight = 1;
+        for (int i = 0; i < CELLS; i++)
+        {
+            int cell = start + i < CELLS ? start + i : start + i - CELLS;
+            if (state.placed[cell])
+            {
+                continue;
+            }
+            int count = SudokuBits::popCount(state.candidates[cell]);
+            int weight = 0;
+            for (int unit : Geometry::unitsOf(cell))
+            {
+                weight += search.weights[unit];
+            }
+            if (count * bestWeight < bestCount * weight)
+            {
+                bestCount = count;
+                bestWeight = weight;
+                best = cell;
+            }
+        }
+
+        // A digit with only two places in a unit branches as narrowly as a bivalue
+        // cell; the two branches are disjoint, so counting stays exact
+        int bestUnit = -1;
+        unsigned bestDigit = 0;
+        if (bestCount > 2 && Step::BRANCH_ON_DIGITS)
+        {
+            for (int unit = 0; unit < Geometry::UNIT_COUNT; unit++)
+            {
+                unsigned once = 0;
+                unsigned twice = 0;
+                unsigned more = 0;
+                for (int cell : GRID_UNITS<Geometry>[unit])
+                {
+                    unsigned c = state.placed[cell] ? 0 : state.candidates[cell];
+                    more |= twice & c;
+                    twice |= once & c;
+                    once |= c;
+                }
+                unsigned pairs = twice & ~more;
+                if (pairs)
+                {
+                    bestUnit = unit;
+                    bestDigit = pairs & (0u - pairs);
+                    break;
+                }
+            }
+        }
+
+        if (bestUnit >= 0)
+        {
+            int last = -1;
+            for (int cell : GRID_UNITS<Geometry>[bestUnit])
+            {
+                if (state.placed[cell] || !(state.candidates[cell] & bestDigit) || search.found >= search.limit)
+                {
+                    continue;
+                }
+                if (search.avoid && (1u << (search.avoid[cell] - 1)) == bestDigit)
+                {
+                    last = cell;
+                    continue;
+                }
+                branch(state, cell, bestDigit, search);
+            }
+            if (last >= 0 && search.found < search.limit)
+            {
+                branch(state, last, bestDigit, search);
+            }
+            return;
+        }
+
+        unsigned candidates = state.candidates[best];
+        unsigned last = search.avoid ? candidates & (1u << (search.avoid[best] - 1)) : 0;
+        for (candidates &= ~last; candidates && search.found < search.limit; candidates &= candidates - 1)
+        {
+            branch(state, best, candidates & (0u - candidates), search);
+        }
+        if (last && search.found < search.limit)
+        {
+            branch(state, best, last, search);
+        }
+    }
+
+    static bool isAvoided(const State &state, const uint8_t *avoid)
+    {
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            if (state.candidates[cell] != (1u << (avoid[cell] - 1)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif // SUDOKU_GRID_SOLVER_HPP
@@ -0,0 +1,300 @@
+#ifndef SUDOKU_GRID_TECHNIQUES_HPP
+#define SUDOKU_GRID_TECHNIQUES_HPP
+
+#include "SudokuAdvancedChecks.hpp"
+#include "SudokuBits.hpp"
+#include "SudokuGrid.hpp"
+
+// The logical techniques of SudokuAdvancedChecks for any GridGeometry, over
+// candidate masks: naked and hidden singles, locked candidates (pointing and
+// claiming) and naked pairs. Each technique makes one pass and reports whether
+// it changed anything. Units a variant adds take part in everything but locked
+// candidates, which only pair boxes with lines and so skip multi-grid shapes.
+// rate() grades puzzles on the same scale as SudokuAdvancedChecks::ratePuzzle.
+template <typename Geometry>
+class SudokuGridTechniques
+{
+public:
+    using Grid = SudokuGrid<Geometry>;
+    using Mask = typename Geometry::Mask;
+
+    static const int SIZE = Geometry::SIZE;
+    static const int CELLS = Geometry::CELLS;
+
+    // Candidate masks for every cell, kept consistent as digits are placed
+    struct Candidates
+    {
+        uint8_t values[CELLS];
+        Mask candidates[CELLS];
+        int filled = 0;
+        bool broken = false;
+
+        void place(int cell, int digit)
+        {
+            unsigned bit = 1u << (digit - 1);
+            if (!(candidates[cell] & bit))
+            {
+                broken = true;
+                return;
+            }
+            values[cell] = static_cast<uint8_t>(digit);
+            candidates[cell] = 0;
+            filled++;
+            for (int peer : GRID_PEERS<Geometry>[cell])
+            {
+                candidates[peer] = static_cast<Mask>(candidates[peer] & ~bit);
+            }
+        }
+
+        bool eliminate(int cell, unsigned mask)
+        {
+            if (!(candidates[cell] & mask))
+            {
+                return false;
+            }
+            candidates[cell] = static_cast<Mask>(candidates[cell] & ~mask);
+            if (candidates[cell] == 0)
+            {
+                broken = true;
+            }
+            return true;
+        }
+    };
+
+    static void load(const Grid &grid, Candidates &state)
+    {
+        state.filled = 0;
+        state.broken = false;
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            state.values[cell] = 0;
+            state.candidates[cell] = Geometry::ALL_DIGITS;
+        }
+        for (int cell = 0; cell < CELLS && !state.broken; cell++)
+        {
+            if (grid.data()[cell] != 0)
+            {
+                state.place(cell, grid.data()[cell]);
+            }
+        }
+    }
+
+    static bool nakedSingles(Candidates &state)
+    {
+        bool progress = false;
+        for (int cell = 0; cell < CELLS && !state.broken; cell++)
+        {
+            unsigned mask = state.candidates[cell];
+            if (state.values[cell] == 0 && mask != 0 && (mask & (mask - 1)) == 0)
+            {
+                state.place(cell, SudokuBits::lowestBit(mask) + 1);
+                progress = true;
+            }
+        }
+        return progress;
+    }
+
+    static bool hiddenSingles(Candidates &state)
+    {
+        bool progress = false;
+        for (const auto &unit : GRID_UNITS<Geometry>)
+        {
+            unsigned once = 0;
+            unsigned twice = 0;
+            for (int cell : unit)
+            {
+                twice |= once & state.candidates[cell];
+                once |= state.candidates[cell];
+            }
+            for (unsigned hidden = once & ~twice; hidden && !state.broken; hidden &= hidden - 1)
+            {
+                unsigned bit = hidden & (0u - hidden);
+                for (int cell : unit)
+                {
+                    if (state.candidates[cell] & bit)
+                    {
+                        state.place(cell, SudokuBits::lowestBit(bit) + 1);
+                        progress = true;
+                        break;
+                    }
+                }
+            }
+        }
+        return progress;
+    }
+
+    // A digit confined to one line within a box leaves the rest of that line
+    // (pointing), and one confined to one box within a line leaves the rest of
+    // that box (claiming)
+    static bool lockedCandidates(Candidates &state)
+    {
+        bool progress = false;
+        if (Geometry::ROWS != SIZE)
+        {
+            return progress;
+        }
+        for (int unit = 0; unit < 3 * SIZE && !state.broken; unit++)
+        {
+            bool isBox = unit >= 2 * SIZE;
+            for (unsigned bit = 1; bit <= Geometry::ALL_DIGITS; bit <<= 1)
+            {
+                int first = -1;
+                bool sameRow = true;
+                bool sameCol = true;
+                bool sameBox = true;
+                for (int cell : GRID_UNITS<Geometry>[unit])
+                {
+                    if (!(state.candidates[cell] & bit))
+                    {
+                        continue;
+                    }
+                    if (first < 0)
+                    {
+                        first = cell;
+                        continue;
+                    }
+                    sameRow = sameRow && Geometry::rowOf(cell) == Geometry::rowOf(first);
+                    sameCol = sameCol && Geometry::colOf(cell) == Geometry::colOf(first);
+                    sameBox = sameBox && Geometry::boxOf(cell) == Geometry::boxOf(first);
+                }
+                if (first < 0)
+                {
+                    continue;
+                }
+
+                int target = -1;
+                if (isBox && sameRow)
+                    target = Geometry::rowOf(first);
+                else if (isBox && sameCol)
+                    target = SIZE + Geometry::colOf(first);
+                else if (!isBox && sameBox)
+                    target = 2 * SIZE + Geometry::boxOf(first);
+                if (target < 0)
+                {
+                    continue;
+                }
+
+                for (int cell : GRID_UNITS<Geometry>[target])
+                {
+                    if (!inUnit(cell, unit))
+                    {
+                        progress |= state.eliminate(cell, bit);
+                    }
+                }
+            }
+        }
+        return progress;
+    }
+
+    // Two cells of a unit holding the same two candidates take those digits
+    // from the rest of the unit
+    static bool nakedPairs(Candidates &state)
+    {
+        bool progress = false;
+        for (const auto &unit : GRID_UNITS<Geometry>)
+        {
+            for (int i = 0; i < SIZE; i++)
+            {
+                unsigned pair = state.candidates[unit[i]];
+                if (SudokuBits::popCount(pair) != 2)
+                {
+                    continue;
+                }
+                for (int j = i + 1; j < SIZE; j++)
+                {
+                    if (state.candidates[unit[j]] != pair)
+                    {
+                        continue;
+                    }
+                    for (int k = 0; k < SIZE; k++)
+                    {
+                        if (k != i && k != j)
+                        {
+                            progress |= state.eliminate(unit[k], pair);
+                        }
+                    }
+                }
+            }
+        }
+        return progress;
+    }
+
+    // Apply the simplest technique that makes progress; SEARCH if none does
+    static Technique step(Candidates &state)
+    {
+        if (hiddenSingles(state))
+            return Technique::HIDDEN_SINGLE;
+        if (nakedSingles(state))
+            return Technique::NAKED_SINGLE;
+        if (lockedCandidates(state))
+            return Technique::LOCKED_CANDIDATES;
+        if (nakedPairs(state))
+            return Technique::NAKED_PAIR;
+        return Technique::SEARCH;
+    }
+
+    // Apply the techniques, simplest first, until none makes progress. The digits
+    // placed are written to grid; true if it ends up solved.
+    static bool solveWithTechniques(Grid &grid)
+    {
+        Candidates state;
+        load(grid, state);
+        while (!state.broken && state.filled < CELLS && step(state) != Technique::SEARCH)
+        {
+        }
+        if (state.broken)
+        {
+            return false;
+        }
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            if (state.values[cell] != 0)
+            {
+                grid.data()[cell] = state.values[cell];
+            }
+        }
+        return state.filled == CELLS;
+    }
+
+    // Grade a puzzle by the hardest technique it needs, SEARCH if they stall
+    static PuzzleRating rate(const Grid &grid)
+    {
+        PuzzleRating rating;
+        Candidates state;
+        load(grid, state);
+        while (!state.broken && state.filled < CELLS)
+        {
+            Technique used = step(state);
+            if (state.broken)
+            {
+                break;
+            }
+            int score = SudokuAdvancedChecks::techniqueScore(used);
+            if (score > rating.score)
+            {
+                rating.score = score;
+                rating.hardest = used;
+            }
+            if (used == Technique::SEARCH)
+            {
+                return rating;
+            }
+            rating.steps++;
+        }
+        rating.consistent = !state.broken;
+        rating.solved = !state.broken && state.filled == CELLS;
+        return rating;
+    }
+
+private:
+    static bool inUnit(int cell, int unit)
+    {
+        if (unit < SIZE)
+            return Geometry::rowOf(cell) == unit;
+        if (unit < 2 * SIZE)
+            return Geometry::colOf(cell) == unit - SIZE;
+        return Geometry::boxOf(cell) == unit - 2 * SIZE;
+    }
+};
+
+#endif // SUDOKU_GRID_TECHNIQUES_HPP
@@ -0,0 +1,80 @@
+#ifndef SUDOKU_GRID_VALIDATOR_HPP
+#define SUDOKU_GRID_VALIDATOR_HPP
+
+#include "SudokuGrid.hpp"
+#include <string>
+
+// SudokuValidator's checks for any geometry, variants included: each unit is
+// reduced to one digit mask, and then the peer table catches the pairwise rules
+// (anti-knight and the like) that no unit covers.
+template <typename Geometry>
+class SudokuGridValidator
+{
+public:
+    using Grid = SudokuGrid<Geometry>;
+
+    static const int VALID = -1;
+    static const int SIZE = Geometry::SIZE;
+    static const int CELLS = Geometry::CELLS;
+
+    // First unit (numbered as GRID_UNITS) that repeats a digit, or VALID; blanks are ignored
+    static int firstConflictingUnit(const Grid &grid)
+    {
+        const uint8_t *cells = grid.data();
+        for (int unit = 0; unit < Geometry::UNIT_COUNT; unit++)
+        {
+            uint32_t seen = 0;
+            for (int cell : GRID_UNITS<Geometry>[unit])
+            {
+                uint32_t bit = cells[cell] ? 1u << (cells[cell] - 1) : 0;
+                if (seen & bit)
+                {
+                    return unit;
+                }
+                seen |= bit;
+            }
+        }
+        return VALID;
+    }
+
+    // First cell whose digit reappears among its peers, or VALID
+    static int firstConflictingCell(const Grid &grid)
+    {
+        const uint8_t *cells = grid.data();
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            if (cells[cell] == 0)
+            {
+                continue;
+            }
+            for (int peer : GRID_PEERS<Geometry>[cell])
+            {
+                if (cells[peer] == cells[cell])
+                {
+                    return cell;
+                }
+            }
+        }
+        return VALID;
+    }
+
+    // "" if the grid breaks no rule, else what it breaks ("row 3", "diagonal 1",
+    // "cell r2c5" for a pairwise rule)
+    static std::string conflict(const Grid &grid)
+    {
+        int unit = firstConflictingUnit(grid);
+        if (unit != VALID)
+        {
+            return Geometry::unitName(unit);
+        }
+        int cell = firstConflictingCell(grid);
+        if (cell != VALID)
+        {
+            return "cell r" + std::to_string(Geometry::rowOf(cell) + 1) + "c" +
+                   std::to_string(Geometry::colOf(cell) + 1);
+        }
+        return "";
+    }
+};
+
+#endif // SUDOKU_GRID_VALIDATOR_HPP
@@ -0,0 +1,51 @@
+#ifndef SUDOKU_HISTOGRAM_HPP
+#define SUDOKU_HISTOGRAM_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Log-linear histogram of non-negative integer samples (typically nanoseconds).
+// Each power of two is split into SUB_BUCKETS linear buckets, so any percentile
+// is reported to within 1/SUB_BUCKETS (about 6%) of the true value, over the
+// whole 64-bit range, in a fixed 8 KiB table. Recording is a few instructions;
+// histograms from several threads are combined with merge().
+class SudokuHistogram
+{
+public:
+    static const int SUB_BUCKETS = 16;
+    static const int BUCKETS = 64 * SUB_BUCKETS;
+
+    SudokuHistogram();
+
+    void record(uint64_t value);
+    void merge(const SudokuHistogram &other);
+    void clear();
+
+    uint64_t count() const { return samples; }
+    uint64_t min() const { return samples ? smallest : 0; }
+    uint64_t max() const { return largest; }
+    double mean() const { return samples ? static_cast<double>(total) / samples : 0.0; }
+
+    // Value at or below which a fraction q (0-1) of samples fall; the top of its
+    // bucket, never above max()
+    uint64_t percentile(double q) const;
+
+    // "p50 1.2us p90 ... max ..." for nanosecond samples
+    std::string summary() const;
+
+    // Format nanoseconds with a unit (ns, us, ms, s)
+    static std::string formatNanos(uint64_t nanos);
+
+private:
+    static int bucketOf(uint64_t value);
+    static uint64_t bucketTop(int bucket);
+
+    std::array<uint64_t, BUCKETS> counts;
+    uint64_t samples;
+    uint64_t smallest;
+    uint64_t largest;
+    uint64_t total;
+};
+
+#endif // SUDOKU_HISTOGRAM_HPP
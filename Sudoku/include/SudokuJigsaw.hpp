@@ -0,0 +1,82 @@
+#ifndef SUDOKU_JIGSAW_HPP
+#define SUDOKU_JIGSAW_HPP
+
+#include "SudokuGrid.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+
+// 9x9 with irregular regions in place of the boxes. Units 18-26 are the regions
+// of the installed layout, and boxOf() gives a cell's region, so the templated
+// solver, generator, techniques and validator run on it unchanged. Its tables
+// are the one pair of GRID_UNITS / GRID_PEERS that is filled at run time, by
+// SudokuJigsaw::install; until then they hold the classic boxes. Being
+// process-wide, they hold a single layout for the life of the process: puzzles
+// that each bring their own layout are not supported. A cell can see up to 24
+// others, and rows with fewer repeat their first peer, as VariantGeometry does.
+struct JigsawGeometry : Geometry9
+{
+    static const int PEER_COUNT = 24;
+
+    // Line shuffles would tear regions apart
+    static const bool SHUFFLE_LINES = false;
+
+    using PeerTable = std::array<std::array<Cell, PEER_COUNT>, CELLS>;
+
+    // Region of every cell in the installed layout
+    inline static std::array<uint8_t, CELLS> regions = [] {
+        std::array<uint8_t, CELLS> boxes{};
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            boxes[cell] = static_cast<uint8_t>(Geometry9::boxOf(cell));
+        }
+        return boxes;
+    }();
+
+    static int boxOf(int cell) { return regions[cell]; }
+
+    static std::array<int, 3> unitsOf(int cell) { return {rowOf(cell), SIZE + colOf(cell), 2 * SIZE + boxOf(cell)}; }
+
+    // Peer table of a layout: the row, then the column, then the rest of the region
+    static PeerTable makePeers(const std::array<uint8_t, CELLS> &layout);
+
+    // "row 3", "column 7", "region 1" (1-based for display)
+    static std::string unitName(int unit);
+};
+
+template <>
+inline JigsawGeometry::UnitTable GRID_UNITS<JigsawGeometry> = Geometry9::makeUnits();
+
+template <>
+inline JigsawGeometry::PeerTable GRID_PEERS<JigsawGeometry> = JigsawGeometry::makePeers(JigsawGeometry::regions);
+
+// Jigsaw layouts: 81 region labels, one character per cell in row-major order
+// (whitespace ignored, so 9 lines of 9 read naturally), with any 9 distinct
+// labels, for example
+//   111222333
+//   111222333
+//   ...
+class SudokuJigsaw
+{
+public:
+    using Layout = std::array<uint8_t, 81>;
+
+    // Read a layout and number its regions 0-8 in order of first appearance.
+    // False with a reason in error if the text is not a valid layout.
+    static bool parseLayout(const std::string &text, Layout &layout, std::string &error);
+
+    // Nine regions of nine orthogonally connected cells each; false with a reason otherwise
+    static bool validateLayout(const Layout &layout, std::string &error);
+
+    // Make layout the regions of JigsawGeometry, building its unit and peer
+    // tables. Call it before any search on JigsawGeometry starts; searches read
+    // the tables without locking. Only the first layout is installed: installing
+    // the same one again does nothing, and a different one fails with a reason
+    // in error, as the tables cannot change under searches already running.
+    static bool install(const Layout &layout, std::string &error);
+
+    // parseLayout + install from a file; false (nothing new installed) with a reason in error
+    static bool loadLayout(const std::string &filename, std::string &error);
+};
+
+#endif // SUDOKU_JIGSAW_HPP
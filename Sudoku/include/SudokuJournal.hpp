@@ -0,0 +1,87 @@
+#ifndef SUDOKU_JOURNAL_HPP
+#define SUDOKU_JOURNAL_HPP
+
+#include "SudokuBoard.hpp"
+#include "SudokuMoveHistory.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Append-only autosave of a game session. The file starts with the puzzle and
+// then grows by one tiny record per move, undo or redo. Each record is one
+// buffered write, flushed to the OS at once so a crash of the game loses nothing.
+// The disk sync that guards against a power cut runs on a background thread once
+// a record is waiting and the last sync is SYNC_INTERVAL old, so the last move
+// before the player goes idle still reaches the disk within SYNC_INTERVAL and no
+// move waits on a sync. The journal is also synced when started or closed:
+//
+//   "SDKJRNL1"                      magic
+//   'P' + 41-byte packed board      puzzle (once, right after the magic)
+//   'M' cell old new                move (4 bytes)
+//   'C' cell old new                move chained to the one before (4 bytes)
+//   'U' / 'R'                       undo / redo (1 byte)
+//
+// Replaying rebuilds the board and the undo/redo history; a torn final record
+// is dropped.
+class SudokuJournal
+{
+public:
+    static constexpr std::chrono::seconds SYNC_INTERVAL{1};
+
+    SudokuJournal();
+    ~SudokuJournal();
+
+    SudokuJournal(const SudokuJournal &) = delete;
+    SudokuJournal &operator=(const SudokuJournal &) = delete;
+
+    // Start a new journal for puzzle. The old file is replaced atomically, so a
+    // crash here leaves either the old session or the new one.
+    bool begin(const std::string &filename, const SudokuBoard &puzzle);
+
+    // Continue appending to a journal that replay() accepted
+    bool resume(const std::string &filename, long validLength);
+
+    bool appendMove(const Move &move);
+    bool appendUndo();
+    bool appendRedo();
+
+    // Push everything appended so far to storage now
+    void sync();
+
+    // Sync and close
+    void close();
+    bool isOpen() const { return file != nullptr; }
+
+    // Rebuild a session. puzzle receives the starting grid, board the grid after
+    // every journaled change. validLength is the size up to the last complete
+    // record. False if the file is missing or not a journal.
+    static bool replay(const std::string &filename, SudokuBoard &puzzle, SudokuBoard &board,
+                       SudokuMoveHistory &history, long &validLength);
+
+private:
+    // Write and flush one record, and wake the sync thread if it was idle
+    bool append(const unsigned char *record, size_t size);
+
+    // Open filename for appending and start the sync thread if needed
+    bool openForAppend(const std::string &filename);
+
+    // Sync thread: sync whenever a record waits and the last sync is SYNC_INTERVAL old
+    void syncLoop();
+
+    // sync() with mutex held
+    void syncLocked();
+
+    std::FILE *file;
+    bool unsynced;
+    std::chrono::steady_clock::time_point lastSync;
+
+    std::mutex mutex; // Guards file, unsynced and lastSync against the sync thread
+    std::condition_variable wake;
+    std::thread syncer;
+    bool stopping;
+};
+
+#endif // SUDOKU_JOURNAL_HPP
@@ -0,0 +1,70 @@
+#ifndef SUDOKU_KILLER_HPP
+#define SUDOKU_KILLER_HPP
+
+#include "SudokuBoard.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One cage: its cells (row * 9 + col) hold distinct digits adding up to sum
+struct KillerCage
+{
+    int sum = 0;
+    std::vector<int> cells;
+};
+
+// A Killer Sudoku: classic rules on a SudokuBoard of givens (usually none), plus
+// cages. The text form is one line: the 81 givens as for a plain puzzle, then
+// one "sum:cell,cell,..." field per cage, separated by spaces, for example
+//   ................................................................................. 3:0,1 15:2,3,4 ...
+class SudokuKiller
+{
+public:
+    static const int MAX_CAGE_SIZE = 9;
+    static const int NO_CAGE = -1;
+
+    SudokuKiller();
+
+    // Add a cage; false (nothing added) if it is empty or larger than 9 cells, a
+    // cell is off the board or already caged, or no set of distinct digits adds
+    // up to sum
+    bool addCage(int sum, const std::vector<int> &cells);
+
+    void clearCages();
+
+    const std::vector<KillerCage> &getCages() const { return cages; }
+
+    // Index into getCages() of the cage holding cell, or NO_CAGE
+    int cageOf(int cell) const { return cageIndex[cell]; }
+
+    // True if every cell is in a cage
+    bool coversBoard() const;
+
+    SudokuBoard &getGivens() { return givens; }
+    const SudokuBoard &getGivens() const { return givens; }
+
+    // True if value can go at (row, col) of board under both the classic and the
+    // cage rules: no repeat within the cage, the cage total stays below its sum
+    // while it has blanks, and hits it exactly once it is full
+    bool isValidMove(const SudokuBoard &board, int row, int col, int value) const;
+
+    // First cage of board (blanks allowed) that repeats a digit, exceeds its sum,
+    // or is full and misses it; NO_CAGE if none
+    int firstBrokenCage(const SudokuBoard &board) const;
+
+    // Read the one-line text form; false (puzzle unchanged) if malformed
+    bool parse(const std::string &line);
+
+    // The one-line text form
+    std::string format() const;
+
+private:
+    bool cageAllows(const uint8_t *cells, int cage) const;
+
+    SudokuBoard givens;
+    std::vector<KillerCage> cages;
+    std::array<int8_t, 81> cageIndex;
+};
+
+#endif // SUDOKU_KILLER_HPP
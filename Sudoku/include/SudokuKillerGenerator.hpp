@@ -0,0 +1,36 @@
+#ifndef SUDOKU_KILLER_GENERATOR_HPP
+#define SUDOKU_KILLER_GENERATOR_HPP
+
+#include "SudokuGenerator.hpp"
+#include "SudokuKiller.hpp"
+#include <cstdint>
+#include <random>
+
+// Work spent generating one Killer puzzle
+struct KillerGenerationStats
+{
+    int uniquenessChecks = 0; // findOtherSolution calls
+    long long nodes = 0;      // Search nodes across those calls
+    int givens = 0;           // Givens the final puzzle kept
+};
+
+// Killer puzzles with a unique solution. A random complete grid is cut into
+// connected cages of distinct digits, up to maxCageSize cells each. Then, while
+// SudokuKillerSolver::findOtherSolution turns up a second solution, one cell
+// where the two differ becomes a given. Medium and hard puzzles finally drop
+// every given that uniqueness can do without.
+class SudokuKillerGenerator
+{
+public:
+    static SudokuKiller generatePuzzle(Difficulty difficulty, std::mt19937 &random,
+                                       KillerGenerationStats *stats = nullptr);
+
+    // Largest cage per difficulty: 3, 4 and 5 cells
+    static int maxCageSize(Difficulty difficulty);
+
+private:
+    // Cover the grid with random connected cages of distinct digits
+    static void cutCages(const uint8_t *solution, int maxSize, std::mt19937 &random, SudokuKiller &puzzle);
+};
+
+#endif // SUDOKU_KILLER_GENERATOR_HPP
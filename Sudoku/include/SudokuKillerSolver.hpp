@@ -0,0 +1,44 @@
+#ifndef SUDOKU_KILLER_SOLVER_HPP
+#define SUDOKU_KILLER_SOLVER_HPP
+
+#include "SudokuKiller.hpp"
+#include "SudokuSolver.hpp"
+#include <atomic>
+#include <cstdint>
+
+// Killer Sudoku on SudokuGridSolver<Geometry9>, with the cages as its
+// propagation step. Once singles stall, every cage is narrowed through a table,
+// built once, of each (cells left, sum left, digits allowed) case: the digits
+// that appear in some set of distinct allowed digits with that size and sum, and
+// those that appear in every such set. A cage that no set fits is a
+// contradiction, and a required digit with one place left in the cage is placed
+// there.
+class SudokuKillerSolver
+{
+public:
+    // Digits (bit d - 1 for digit d) used by some set of size distinct digits from
+    // allowed that adds up to sum; 0 if there is none
+    static unsigned combinationDigits(int size, int sum, unsigned allowed);
+
+    // Digits used by every such set; 0 if there is none
+    static unsigned requiredDigits(int size, int sum, unsigned allowed);
+
+    // Solve into solution (the givens plus every filled cell). Results as for
+    // SudokuSolver: DUPLICATE_GIVEN when the givens already clash with a unit or
+    // cage, EMPTY_CELL or MISSING_DIGIT when propagation alone refutes them,
+    // NO_SOLUTION, or CANCELLED once cancel (polled at every node) is set.
+    static SolveResult solve(const SudokuKiller &puzzle, SudokuBoard &solution,
+                             const std::atomic<bool> *cancel = nullptr, SolverStats *stats = nullptr);
+
+    // Number of solutions, counting no further than maxSolutions
+    static int countSolutions(const SudokuKiller &puzzle, int maxSolutions = 2, SolverStats *stats = nullptr);
+
+    // Uniqueness check against a known solution (81 digits, row-major): true, with
+    // the other solution in other, if the puzzle has a solution that differs from
+    // known. Each branch tries the known digit last, so a second solution usually
+    // turns up within a few nodes.
+    static bool findOtherSolution(const SudokuKiller &puzzle, const uint8_t *known, uint8_t *other,
+                                  SolverStats *stats = nullptr);
+};
+
+#endif // SUDOKU_KILLER_SOLVER_HPP
@@ -0,0 +1,65 @@
+#ifndef SUDOKU_LINE_READER_HPP
+#define SUDOKU_LINE_READER_HPP
+
+#include "SudokuBoard.hpp"
+#include "SudokuMappedFile.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Streaming reader for the one-puzzle-per-line format: 81 characters, digits 1-9
+// for clues and '.' or '0' for blanks, optionally followed by a separator and more
+// fields (ratings, solutions...). Blank lines and lines starting with '#' are skipped.
+// Files are memory mapped; other streams (stdin) go through one large buffer.
+// Lines are validated 16 bytes at a time with SSE2 where available.
+class SudokuLineReader
+{
+public:
+    static const size_t BUFFER_SIZE = 1 << 22;
+
+private:
+    SudokuMappedFile mapped;
+    std::FILE *stream;
+    std::vector<char> buffer;
+    const char *cursor;
+    const char *limit;
+    bool streamDone;
+    long long currentLine;
+    long long badLines;
+
+    // Make sure a complete line (or the end of input) is available at cursor
+    bool refill();
+
+    // Next raw line without its terminator; false at end of input
+    bool nextLine(const char *&line, size_t &length);
+
+public:
+    // Constructor
+    SudokuLineReader();
+
+    // Read a file through a memory mapping
+    bool open(const std::string &filename);
+
+    // Read an already open stream (e.g. stdin) through the internal buffer
+    bool open(std::FILE *input);
+
+    void close();
+
+    // Next valid puzzle as 81 digits (0 = blank); invalid lines are counted and skipped
+    bool next(uint8_t *cells);
+
+    // Next valid puzzle written into an existing board without reallocating it
+    bool next(SudokuBoard &board);
+
+    // Line number of the last puzzle returned (1-based)
+    long long lineNumber() const { return currentLine; }
+
+    // Lines skipped because they were not a puzzle
+    long long invalidLines() const { return badLines; }
+
+    // Validate and convert one line; length excludes the line terminator
+    static bool parseLine(const char *line, size_t length, uint8_t *cells);
+};
+
+#endif // SUDOKU_LINE_READER_HPP
@@ -0,0 +1,41 @@
+#ifndef SUDOKU_MAPPED_FILE_HPP
+#define SUDOKU_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file (mmap on POSIX, file mapping on Windows)
+class SudokuMappedFile
+{
+private:
+    const unsigned char *mappedData;
+    size_t mappedSize;
+    bool opened;
+#ifdef _WIN32
+    void *fileHandle;
+    void *mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+
+public:
+    // Constructor
+    SudokuMappedFile();
+    ~SudokuMappedFile();
+
+    SudokuMappedFile(const SudokuMappedFile &) = delete;
+    SudokuMappedFile &operator=(const SudokuMappedFile &) = delete;
+
+    // Map a file; any previous mapping is released first. An empty file opens
+    // with a null data pointer and size 0.
+    bool open(const std::string &filename);
+
+    // Release the mapping
+    void close();
+
+    bool isOpen() const { return opened; }
+    const unsigned char *data() const { return mappedData; }
+    size_t size() const { return mappedSize; }
+};
+
+#endif // SUDOKU_MAPPED_FILE_HPP
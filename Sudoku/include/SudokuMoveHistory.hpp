@@ -0,0 +1,96 @@
+#ifndef SUDOKU_MOVE_HISTORY_HPP
+#define SUDOKU_MOVE_HISTORY_HPP
+
+#include <array>
+#include <cstdint>
+
+// One change to the board: cell (row * 9 + col) went from oldValue to newValue.
+// A chained move is undone and redone together with the move before it, so a
+// batch such as "solve for me" is taken back in one step. Move{cell, old, new}
+// leaves chained clear.
+struct Move
+{
+    uint8_t cell;
+    uint8_t oldValue;
+    uint8_t newValue : 7;
+    uint8_t chained : 1;
+};
+
+// Undo/redo stack kept in a fixed ring of moves. Every operation is O(1) and
+// nothing is allocated; once the ring is full the oldest moves fall off.
+// Counter only needs to hold Capacity, so small rings stay small.
+template <uint32_t Capacity, typename Counter = uint32_t>
+class SudokuMoveRing
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    static const uint32_t CAPACITY = Capacity;
+
+    SudokuMoveRing() : moves(), cursor(0), undoable(0), redoable(0) {}
+
+    // Forget every move
+    void clear()
+    {
+        cursor = 0;
+        undoable = 0;
+        redoable = 0;
+    }
+
+    // Add a move; discards anything that could have been redone
+    void record(const Move &move)
+    {
+        moves[cursor & (Capacity - 1)] = move;
+        cursor = static_cast<Counter>(cursor + 1);
+        if (undoable < Capacity)
+        {
+            undoable++;
+        }
+        redoable = 0;
+    }
+
+    // Take back the latest move; move receives it so the caller can revert it
+    bool undo(Move &move)
+    {
+        if (undoable == 0)
+        {
+            return false;
+        }
+        cursor = static_cast<Counter>(cursor - 1);
+        undoable--;
+        redoable++;
+        move = moves[cursor & (Capacity - 1)];
+        return true;
+    }
+
+    // Reapply the latest undone move
+    bool redo(Move &move)
+    {
+        if (redoable == 0)
+        {
+            return false;
+        }
+        move = moves[cursor & (Capacity - 1)];
+        cursor = static_cast<Counter>(cursor + 1);
+        undoable++;
+        redoable--;
+        return true;
+    }
+
+    // True if the next redo belongs to the batch of the move redone before it
+    bool redoChained() const { return redoable > 0 && moves[cursor & (Capacity - 1)].chained; }
+
+    uint32_t undoDepth() const { return undoable; }
+    uint32_t redoDepth() const { return redoable; }
+
+private:
+    std::array<Move, Capacity> moves;
+    Counter cursor;   // Slot of the next recorded move (wraps freely)
+    Counter undoable; // Moves behind cursor
+    Counter redoable; // Undone moves from cursor onwards
+};
+
+// History of the interactive game
+using SudokuMoveHistory = SudokuMoveRing<4096>;
+
+#endif // SUDOKU_MOVE_HISTORY_HPP
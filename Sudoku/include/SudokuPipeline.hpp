@@ -0,0 +1,74 @@
+#ifndef SUDOKU_PIPELINE_HPP
+#define SUDOKU_PIPELINE_HPP
+
+#include "SudokuBoard.hpp"
+#include "SudokuLineReader.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+// Settings for a pipelined run
+struct PipelineOptions
+{
+    int workers = 0;         // Worker threads (0 = hardware concurrency)
+    int batchSize = 256;     // Puzzles per batch
+    int batchesPerWorker = 4; // Batches in flight per worker; bounds memory use
+};
+
+// Time one stage (or all workers together) spent working and waiting on queues
+struct StageStats
+{
+    double busySeconds = 0.0;
+    double waitSeconds = 0.0;
+
+    double utilization() const
+    {
+        double total = busySeconds + waitSeconds;
+        return total > 0 ? busySeconds / total : 0.0;
+    }
+};
+
+struct PipelineStats
+{
+    long long puzzles = 0;
+    long long invalidLines = 0;
+    double seconds = 0.0;
+    int workers = 0;
+    StageStats reader;
+    StageStats solvers;
+    StageStats writer;
+
+    // One-line summary naming the stage that limits throughput
+    std::string summary() const;
+};
+
+// Three-stage executor: a reader thread parses puzzle lines into batches, a pool of
+// workers runs the handler on every puzzle of a batch, and a writer thread emits the
+// results in input order. Stages are connected by bounded lock-free rings of batch
+// pointers and all batches are allocated up front, so memory stays flat however
+// large the input is; a full ring makes the producing stage wait.
+class SudokuPipeline
+{
+public:
+    static const int MAX_RESULT_LENGTH = 160;
+
+    // Per-puzzle work: fill out (no newline, at most MAX_RESULT_LENGTH bytes) and
+    // return its length. Called concurrently from several workers.
+    using Handler = std::function<int(SudokuBoard &board, const char *line, char *out)>;
+
+    // Whole-batch work: cells holds count * 81 digits; fill results (MAX_RESULT_LENGTH
+    // bytes per puzzle) and lengths. Lets a worker process a batch in one go.
+    using BatchHandler = std::function<void(const uint8_t *cells, int count, char *results, int *lengths)>;
+
+    // Adapt a per-puzzle handler to the batch interface
+    static BatchHandler forEachPuzzle(const Handler &handler);
+
+    static bool run(SudokuLineReader &reader, std::FILE *out, const Handler &handler,
+                    const PipelineOptions &options, PipelineStats &stats);
+
+    static bool run(SudokuLineReader &reader, std::FILE *out, const BatchHandler &handler,
+                    const PipelineOptions &options, PipelineStats &stats);
+};
+
+#endif // SUDOKU_PIPELINE_HPP
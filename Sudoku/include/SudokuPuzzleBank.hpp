@@ -0,0 +1,87 @@
+#ifndef SUDOKU_PUZZLE_BANK_HPP
+#define SUDOKU_PUZZLE_BANK_HPP
+
+#include "SudokuBoard.hpp"
+#include "SudokuGenerator.hpp"
+#include "SudokuMappedFile.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+
+// Binary puzzle bank, opened by memory mapping so opening costs the same for any size.
+//
+// Layout (host byte order):
+//   header, HEADER_SIZE bytes: magic "SDKBANK1", version, record size, record count,
+//                              then first record and record count for each Difficulty
+//   records, RECORD_SIZE bytes each, grouped by difficulty in enum order:
+//       puzzle and solution in SudokuBoard's 41-byte packed form, 16-bit rating
+class SudokuPuzzleBank
+{
+public:
+    static const int HEADER_SIZE = 128;
+    static const int RECORD_SIZE = 84;
+    static const int DIFFICULTY_COUNT = 3;
+
+private:
+    SudokuMappedFile file;
+    const unsigned char *records;
+    uint64_t totalCount;
+    uint64_t firstRecord[DIFFICULTY_COUNT];
+    uint64_t recordCount[DIFFICULTY_COUNT];
+
+public:
+    // Constructor
+    SudokuPuzzleBank();
+
+    // Map a bank file and check its header. Nothing is read beyond the header.
+    bool open(const std::string &filename);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+    // Record counts
+    uint64_t size() const { return totalCount; }
+    uint64_t count(Difficulty difficulty) const;
+
+    // Raw record for the index-th puzzle of a difficulty, or nullptr if out of range
+    const unsigned char *record(Difficulty difficulty, uint64_t index) const;
+
+    // Unpack the index-th puzzle of a difficulty
+    bool getPuzzle(Difficulty difficulty, uint64_t index, SudokuBoard &puzzle,
+                   SudokuBoard *solution = nullptr, int *rating = nullptr) const;
+
+    // Unpack a uniformly chosen puzzle of a difficulty
+    bool randomPuzzle(Difficulty difficulty, std::mt19937 &random, SudokuBoard &puzzle,
+                      SudokuBoard *solution = nullptr, int *rating = nullptr) const;
+};
+
+// Builds a bank file. Records are spilled to one side file per difficulty while
+// adding, so a bank of any size can be written without holding it in memory.
+class SudokuPuzzleBankWriter
+{
+private:
+    std::string bankFilename;
+    std::FILE *spillFiles[SudokuPuzzleBank::DIFFICULTY_COUNT];
+    uint64_t spillCounts[SudokuPuzzleBank::DIFFICULTY_COUNT];
+
+    std::string spillName(int difficulty) const;
+
+public:
+    // Constructor
+    SudokuPuzzleBankWriter();
+    ~SudokuPuzzleBankWriter();
+
+    SudokuPuzzleBankWriter(const SudokuPuzzleBankWriter &) = delete;
+    SudokuPuzzleBankWriter &operator=(const SudokuPuzzleBankWriter &) = delete;
+
+    // Start a new bank at filename
+    bool open(const std::string &filename);
+
+    // Append one puzzle with its solution and grader score
+    bool add(const SudokuBoard &puzzle, const SudokuBoard &solution, int rating, Difficulty difficulty);
+
+    // Write the header and records to the bank file and remove the spill files
+    bool finish();
+};
+
+#endif // SUDOKU_PUZZLE_BANK_HPP
@@ -0,0 +1,59 @@
+#ifndef SUDOKU_PUZZLE_BUFFER_HPP
+#define SUDOKU_PUZZLE_BUFFER_HPP
+
+#include "SudokuBoard.hpp"
+#include "SudokuGenerator.hpp"
+#include "SudokuPuzzleBank.hpp"
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+
+// Stock of ready-made puzzles per difficulty, topped up by a background thread,
+// so generate requests are answered without waiting for the generator. Given a
+// puzzle bank, puzzles are drawn from it instead, for every difficulty it holds.
+// Every caller of generate() passes its own random engine, so generations on
+// different threads run in parallel.
+class SudokuPuzzleBuffer
+{
+public:
+    static const int DIFFICULTY_COUNT = 3;
+
+    // capacity puzzles per difficulty; 0 disables the stock and the refill thread.
+    // bank, if given, must stay open for the buffer's lifetime.
+    explicit SudokuPuzzleBuffer(int capacity, const SudokuPuzzleBank *bank = nullptr);
+    ~SudokuPuzzleBuffer();
+
+    SudokuPuzzleBuffer(const SudokuPuzzleBuffer &) = delete;
+    SudokuPuzzleBuffer &operator=(const SudokuPuzzleBuffer &) = delete;
+
+    // Take a stocked puzzle (81 digits); false if none is ready
+    bool take(Difficulty difficulty, uint8_t *cells);
+
+    // Draw a puzzle from the bank, or generate one now, using the caller's engine
+    void generate(Difficulty difficulty, uint8_t *cells, std::mt19937 &random);
+
+    // Puzzles in stock for difficulty
+    size_t available(Difficulty difficulty);
+
+private:
+    using Packed = std::array<uint8_t, SudokuBoard::PACKED_SIZE>;
+
+    // Refill thread body: keep every stock full, sleeping while they are
+    void refill();
+
+    int capacity;
+    bool stopping;
+    std::mutex stockMutex;
+    std::condition_variable stockTaken;
+    std::deque<Packed> stock[DIFFICULTY_COUNT];
+
+    std::thread refiller;
+
+    const SudokuPuzzleBank *bank;
+};
+
+#endif // SUDOKU_PUZZLE_BUFFER_HPP
@@ -0,0 +1,59 @@
+#ifndef SUDOKU_RENDERER_HPP
+#define SUDOKU_RENDERER_HPP
+
+#include "SudokuBoard.hpp"
+#include <cstddef>
+#include <cstdint>
+
+enum class RenderMode
+{
+    PLAIN, // Whole board every frame, as plain text that scrolls
+    ANSI   // Board pinned to the top of the terminal; later frames repaint changed cells only
+};
+
+// Draws the board on stdout. Each frame is built in a fixed buffer and handed
+// to the terminal in a single write, instead of one stream insertion per cell.
+// In ANSI mode the text below the board scrolls in its own region, so the board
+// stays in place and a frame after a move is a few cursor jumps and digits.
+class SudokuRenderer
+{
+public:
+    static const int FRAME_LINES = 13;
+    static const size_t FRAME_SIZE = 4 * 38 + 9 * 23; // 4 rule lines, 9 digit lines
+
+    explicit SudokuRenderer(RenderMode mode = RenderMode::PLAIN);
+
+    // Hands the whole screen back to normal scrolling after an ANSI frame
+    ~SudokuRenderer();
+
+    SudokuRenderer(const SudokuRenderer &) = delete;
+    SudokuRenderer &operator=(const SudokuRenderer &) = delete;
+
+    // ANSI when stdout is a terminal that understands escape codes, else PLAIN
+    static RenderMode detectMode();
+
+    // Write the plain-text frame of board (FRAME_SIZE bytes, no terminator)
+    static void formatFrame(const SudokuBoard &board, char *frame);
+
+    // Draw board with one write; in ANSI mode only what changed since the last frame
+    void render(const SudokuBoard &board);
+
+    // Make the next ANSI frame a full repaint
+    void invalidate() { drawn = false; }
+
+    RenderMode getMode() const { return mode; }
+
+private:
+    // Room for a full ANSI repaint, or every cell changed with a cursor jump each
+    static const size_t BUFFER_SIZE = 1024;
+
+    // Emit length bytes of the buffer in one write
+    void flush(size_t length);
+
+    RenderMode mode;
+    bool drawn;
+    uint8_t shown[81];
+    char buffer[BUFFER_SIZE];
+};
+
+#endif // SUDOKU_RENDERER_HPP
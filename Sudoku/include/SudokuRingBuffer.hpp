@@ -0,0 +1,109 @@
+#ifndef SUDOKU_RING_BUFFER_HPP
+#define SUDOKU_RING_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue (Vyukov's sequence-numbered ring). Any number of
+// producers and consumers may use it; the pipeline uses it single-producer /
+// multi-consumer for work and multi-producer / single-consumer for results.
+// Capacity is rounded up to a power of two. Push and pop never block: callers
+// decide how to wait, which is what gives the pipeline its backpressure.
+template <typename T>
+class SudokuRingBuffer
+{
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    // Keep the two cursors on separate cache lines
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) std::vector<Slot> slots;
+    size_t mask;
+
+public:
+    explicit SudokuRingBuffer(size_t capacity) : head(0), tail(0)
+    {
+        size_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        slots = std::vector<Slot>(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mask = size - 1;
+    }
+
+    SudokuRingBuffer(const SudokuRingBuffer &) = delete;
+    SudokuRingBuffer &operator=(const SudokuRingBuffer &) = delete;
+
+    // False if the queue is full
+    bool tryPush(const T &value)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0)
+            {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.value = value;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // False if the queue is empty
+    bool tryPop(T &value)
+    {
+        size_t position = head.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (difference == 0)
+            {
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    value = slot.value;
+                    slot.sequence.store(position + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const { return mask + 1; }
+};
+
+#endif // SUDOKU_RING_BUFFER_HPP
@@ -0,0 +1,279 @@
+#ifndef SUDOKU_SAMURAI_HPP
+#define SUDOKU_SAMURAI_HPP
+
+#include "SudokuGrid.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Where the five 9x9 grids of a Samurai sit on its 21x21 canvas: four in the
+// corners and one in the middle whose corner boxes are theirs
+struct SamuraiLayout
+{
+    static const int GRIDS = 5;
+    static const int SIDE = 21;
+
+    static constexpr int top(int grid) { return grid == 2 ? 6 : (grid < 2 ? 0 : 12); }
+    static constexpr int left(int grid) { return grid == 2 ? 6 : (grid % 3 == 0 ? 0 : 12); }
+
+    static constexpr bool inGrid(int grid, int row, int col)
+    {
+        return row >= top(grid) && row < top(grid) + 9 && col >= left(grid) && col < left(grid) + 9;
+    }
+
+    static constexpr bool onBoard(int row, int col)
+    {
+        for (int grid = 0; grid < GRIDS; grid++)
+        {
+            if (inGrid(grid, row, col))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Cell number of every canvas position, row-major over the positions on the
+    // board, and -1 for the holes between the outer grids
+    static constexpr std::array<int16_t, SIDE * SIDE> makeCells()
+    {
+        std::array<int16_t, SIDE * SIDE> cells{};
+        int next = 0;
+        for (int pos = 0; pos < SIDE * SIDE; pos++)
+        {
+            cells[pos] = static_cast<int16_t>(onBoard(pos / SIDE, pos % SIDE) ? next++ : -1);
+        }
+        return cells;
+    }
+
+    static constexpr int cellCount()
+    {
+        int count = 0;
+        for (int pos = 0; pos < SIDE * SIDE; pos++)
+        {
+            count += onBoard(pos / SIDE, pos % SIDE) ? 1 : 0;
+        }
+        return count;
+    }
+
+    // Canvas position (row * SIDE + col) of every cell
+    static constexpr std::array<int16_t, 369> makePositions()
+    {
+        std::array<int16_t, 369> positions{};
+        int next = 0;
+        for (int pos = 0; pos < SIDE * SIDE; pos++)
+        {
+            if (onBoard(pos / SIDE, pos % SIDE))
+            {
+                positions[next++] = static_cast<int16_t>(pos);
+            }
+        }
+        return positions;
+    }
+
+    // The middle grid's corner boxes are already units of the outer grids
+    static constexpr bool sharedBox(int grid, int box) { return grid == 2 && box != 4 && box % 2 == 0; }
+
+    // First unit of grid: 27 per grid, less the four boxes the middle grid shares
+    static constexpr int unitBase(int grid) { return grid * 27 - (grid > 2 ? 4 : 0); }
+
+    // Offset of box among the box units of grid; the middle grid keeps boxes 1,
+    // 3, 4, 5 and 7 only
+    static constexpr int boxUnit(int grid, int box)
+    {
+        if (grid != 2)
+        {
+            return box;
+        }
+        return box < 4 ? box / 2 : (box + 1) / 2;
+    }
+
+    // Grid holding a position; for a shared box, the outer grid, which owns its box unit
+    static constexpr int gridAt(int row, int col)
+    {
+        for (int grid : {0, 1, 3, 4})
+        {
+            if (inGrid(grid, row, col))
+            {
+                return grid;
+            }
+        }
+        return 2;
+    }
+
+    // Row, column and box unit of every cell in the grid gridAt gives it
+    static constexpr std::array<std::array<int16_t, 3>, 369> makeUnitsOf()
+    {
+        std::array<std::array<int16_t, 3>, 369> units{};
+        int next = 0;
+        for (int pos = 0; pos < SIDE * SIDE; pos++)
+        {
+            if (!onBoard(pos / SIDE, pos % SIDE))
+            {
+                continue;
+            }
+            int grid = gridAt(pos / SIDE, pos % SIDE);
+            int row = pos / SIDE - top(grid);
+            int col = pos % SIDE - left(grid);
+            int base = unitBase(grid);
+            units[next][0] = static_cast<int16_t>(base + row);
+            units[next][1] = static_cast<int16_t>(base + 9 + col);
+            units[next][2] = static_cast<int16_t>(base + 18 + boxUnit(grid, (row / 3) * 3 + col / 3));
+            next++;
+        }
+        return units;
+    }
+};
+
+inline constexpr std::array<int16_t, SamuraiLayout::SIDE * SamuraiLayout::SIDE> SAMURAI_CELLS =
+    SamuraiLayout::makeCells();
+
+inline constexpr std::array<int16_t, 369> SAMURAI_POSITIONS = SamuraiLayout::makePositions();
+
+inline constexpr std::array<std::array<int16_t, 3>, 369> SAMURAI_UNITS_OF = SamuraiLayout::makeUnitsOf();
+
+// Samurai as one grid: the 369 cells of five overlapping 9x9 grids, with every
+// row, column and box of each grid a unit (the four boxes the middle grid shares
+// count once). A shared cell is a peer of both its grids, so a digit placed
+// there is taken out of both by the same propagation as any other peer, and the
+// templated solver, generator, techniques and validator search the whole puzzle
+// at once rather than grid by grid. Units run grid by grid (top left, top right,
+// middle, bottom left, bottom right), rows then columns then boxes. Cells are
+// numbered row-major over the 21x21 canvas, skipping the holes; the text form is
+// those 369 cells in order.
+struct SamuraiGeometry
+{
+    static const int BOX_ROWS = 3;
+    static const int BOX_COLS = 3;
+    static const int SIZE = 9;
+    static const int ROWS = SamuraiLayout::SIDE;
+    static const int COLS = SamuraiLayout::SIDE;
+    static const int CELLS = 369;
+    static const int UNIT_COUNT = SamuraiLayout::GRIDS * 3 * SIZE - 4;
+
+    // A cell in a shared box sees the rows and columns of both its grids: 20
+    // peers in the outer grid and 12 more outside the box in the middle one
+    static const int PEER_COUNT = 32;
+
+    // Line shuffles within one grid would break the grids it overlaps
+    static const bool SHUFFLE_LINES = false;
+
+    static_assert(SamuraiLayout::cellCount() == CELLS, "Five grids less four shared boxes");
+
+    using Mask = uint16_t;
+    using Cell = uint16_t;
+
+    static constexpr Mask ALL_DIGITS = 0x1ff;
+
+    static constexpr int rowOf(int cell) { return SAMURAI_POSITIONS[cell] / SamuraiLayout::SIDE; }
+    static constexpr int colOf(int cell) { return SAMURAI_POSITIONS[cell] % SamuraiLayout::SIDE; }
+
+    // Box of the canvas, 7 to a band
+    static constexpr int boxOf(int cell) { return (rowOf(cell) / 3) * 7 + colOf(cell) / 3; }
+
+    static constexpr int cellAt(int row, int col)
+    {
+        return row >= 0 && row < ROWS && col >= 0 && col < COLS ? SAMURAI_CELLS[row * COLS + col] : -1;
+    }
+
+    // The row, column and box units of cell in one grid holding it (the outer
+    // one for a shared box)
+    static constexpr std::array<int16_t, 3> unitsOf(int cell) { return SAMURAI_UNITS_OF[cell]; }
+
+    using UnitTable = std::array<std::array<Cell, SIZE>, UNIT_COUNT>;
+    using PeerTable = std::array<std::array<Cell, PEER_COUNT>, CELLS>;
+
+    static constexpr UnitTable makeUnits()
+    {
+        UnitTable units{};
+        for (int grid = 0; grid < SamuraiLayout::GRIDS; grid++)
+        {
+            int base = SamuraiLayout::unitBase(grid);
+            int top = SamuraiLayout::top(grid);
+            int left = SamuraiLayout::left(grid);
+            for (int i = 0; i < SIZE; i++)
+            {
+                for (int j = 0; j < SIZE; j++)
+                {
+                    units[base + i][j] = static_cast<Cell>(cellAt(top + i, left + j));
+                    units[base + SIZE + i][j] = static_cast<Cell>(cellAt(top + j, left + i));
+                    if (!SamuraiLayout::sharedBox(grid, i))
+                    {
+                        units[base + 2 * SIZE + SamuraiLayout::boxUnit(grid, i)][j] = static_cast<Cell>(
+                            cellAt(top + (i / 3) * 3 + j / 3, left + (i % 3) * 3 + j % 3));
+                    }
+                }
+            }
+        }
+        return units;
+    }
+
+    // The cells sharing a row, column or box of any of its grids with each cell, in
+    // cell order; cells of a single grid have 20 and repeat their first peer to
+    // fill the row
+    static constexpr PeerTable makePeers()
+    {
+        PeerTable peers{};
+        for (int cell = 0; cell < CELLS; cell++)
+        {
+            int row = rowOf(cell);
+            int col = colOf(cell);
+            std::array<bool, CELLS> seen{};
+            for (int grid = 0; grid < SamuraiLayout::GRIDS; grid++)
+            {
+                if (!SamuraiLayout::inGrid(grid, row, col))
+                {
+                    continue;
+                }
+                for (int i = 0; i < SIZE; i++)
+                {
+                    for (int j = 0; j < SIZE; j++)
+                    {
+                        int r = SamuraiLayout::top(grid) + i;
+                        int c = SamuraiLayout::left(grid) + j;
+                        if (r == row || c == col || (r / 3 == row / 3 && c / 3 == col / 3))
+                        {
+                            seen[cellAt(r, c)] = true;
+                        }
+                    }
+                }
+            }
+            seen[cell] = false;
+            int count = 0;
+            for (int other = 0; other < CELLS; other++)
+            {
+                if (seen[other])
+                {
+                    peers[cell][count++] = static_cast<Cell>(other);
+                }
+            }
+            for (; count < PEER_COUNT; count++)
+            {
+                peers[cell][count] = peers[cell][0];
+            }
+        }
+        return peers;
+    }
+
+    // "grid 2 row 3", "grid 5 column 7", "grid 3 box 1" (1-based for display)
+    static std::string unitName(int unit)
+    {
+        static const char *const kinds[] = {" row ", " column ", " box "};
+        int grid = 0;
+        while (grid + 1 < SamuraiLayout::GRIDS && unit >= SamuraiLayout::unitBase(grid + 1))
+        {
+            grid++;
+        }
+        int index = unit - SamuraiLayout::unitBase(grid);
+        int kind = index / SIZE;
+        index %= SIZE;
+        if (kind == 2 && grid == 2)
+        {
+            // The middle grid's own boxes are 1, 3, 4, 5 and 7 (0-based)
+            index = index < 2 ? 2 * index + 1 : (index == 2 ? 4 : 2 * index - 1);
+        }
+        return "grid " + std::to_string(grid + 1) + kinds[kind] + std::to_string(index + 1);
+    }
+};
+
+#endif // SUDOKU_SAMURAI_HPP
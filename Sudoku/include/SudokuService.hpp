@@ -0,0 +1,52 @@
+#ifndef SUDOKU_SERVICE_HPP
+#define SUDOKU_SERVICE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+class SudokuPuzzleBank;
+
+// Where and how the service listens
+struct ServiceOptions
+{
+    std::string socketPath; // Unix-domain socket; empty for none
+    int tcpPort = 0;        // Port on 127.0.0.1; 0 for none
+    int workers = 0;        // 0 = all cores
+    int batchSize = 64;     // Most requests one worker takes at a time
+    int bufferSize = 0;     // Pre-generated puzzles kept per difficulty; 0 = generate on demand
+    const SudokuPuzzleBank *bank = nullptr; // Draw generated puzzles from this bank where it has them
+};
+
+// Counters reported when the service stops
+struct ServiceStats
+{
+    long long connections = 0;
+    long long requests = 0;
+    long long batches = 0;
+    long long bufferHits = 0; // generate requests served from the stock
+};
+
+// Local solve/generate/rate service. One I/O thread reads newline-terminated
+// requests from every client and queues them; a fixed pool of workers takes
+// them in batches (solves in a batch go through SudokuBatchSolver together) and
+// hands the replies back, which are written to each client in request order:
+//   SOLVE <81 digits>          -> OK <81 digits> | ERR unsolvable
+//   RATE <81 digits>           -> OK <score> <technique> | ERR invalid
+//   GENERATE easy|medium|hard  -> OK <81 digits>
+// Malformed requests get ERR bad-request. Clients may pipeline; a client is
+// not read from while MAX_OUTPUT reply bytes or MAX_PENDING requests are
+// outstanding for it. A client that shuts down its write side still gets every
+// reply (an unterminated last line counts as a request) before it is closed.
+class SudokuService
+{
+public:
+    static const size_t MAX_LINE = 256;
+    static const size_t MAX_OUTPUT = 1 << 20;
+    static const uint64_t MAX_PENDING = 4096;
+
+    // Serve until stop becomes true; false if no listener could be opened
+    static bool run(const ServiceOptions &options, const std::atomic<bool> &stop, ServiceStats &stats);
+};
+
+#endif // SUDOKU_SERVICE_HPP
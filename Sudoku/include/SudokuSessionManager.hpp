@@ -0,0 +1,119 @@
+#ifndef SUDOKU_SESSION_MANAGER_HPP
+#define SUDOKU_SESSION_MANAGER_HPP
+
+#include "SudokuBoard.hpp"
+#include "SudokuMoveHistory.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SudokuPuzzleBuffer;
+
+// Outcome of a session command
+enum class SessionResult
+{
+    OK,
+    NO_SESSION,   // Unknown or closed session id
+    LIMIT,        // Session limit reached
+    BAD_ARGUMENT, // Out-of-range row, column or value, or a malformed puzzle
+    GIVEN,        // The cell holds a given
+    OCCUPIED,     // The cell already holds a digit
+    ILLEGAL,      // The digit is already in the row, column or box
+    NO_UNDO,
+    NO_REDO,
+    WRONG_ENTRY,  // hint: an entry disagrees with the solution (reported instead of a new digit)
+    UNSOLVABLE,
+    SOLVED        // hint: nothing left to fill
+};
+
+// Many games in one process, with no I/O of its own. A session is a fixed-size
+// record (about 240 bytes: grid, given mask, packed solution and a short undo
+// ring) carved from slabs of SLAB_SIZE records; closed records go on a free list
+// and their generation is bumped so stale ids are rejected. The solution is
+// worked out the first time a hint or solve needs it. Given a stock, NEW with a
+// difficulty takes its puzzle from there and never runs the generator itself.
+// Not thread-safe: drive it from one thread (see SudokuSessionServer).
+class SudokuSessionManager
+{
+public:
+    using SessionId = uint64_t;
+
+    static const uint32_t SLAB_SIZE = 4096;
+    static const uint32_t HISTORY_SIZE = 32;
+    static const size_t MAX_REPLY = 128;
+
+    // stock, if given, must outlive the manager
+    explicit SudokuSessionManager(uint32_t maxSessions = 1u << 20, SudokuPuzzleBuffer *stock = nullptr);
+
+    // New session for an 81-digit puzzle (0 = blank)
+    SessionResult create(const uint8_t *cells, SessionId &id);
+    SessionResult close(SessionId id);
+
+    // Place value (1-9) in an empty cell, or clear a player's digit with value 0.
+    // row and col are 0-based.
+    SessionResult move(SessionId id, int row, int col, int value);
+    SessionResult undo(SessionId id);
+    SessionResult redo(SessionId id);
+
+    // Fill the first empty cell from the solution. If an entry is wrong, nothing
+    // is filled: WRONG_ENTRY comes back with that cell and its correct digit.
+    SessionResult hint(SessionId id, int &row, int &col, int &value);
+
+    // Replace the grid with the solution and clear the history
+    SessionResult solve(SessionId id);
+
+    // Copy out the current grid
+    SessionResult cells(SessionId id, uint8_t *out) const;
+
+    size_t sessionCount() const { return activeSessions; }
+
+    // Bytes held by session slabs and the free list
+    size_t memoryUsage() const;
+
+    // Text front end: one command line in, one reply line (no newline) out, at
+    // most MAX_REPLY bytes. Commands:
+    //   NEW <81 digits> | NEW easy|medium|hard   -> OK <id>
+    //   MOVE <id> <row> <col> <value>            -> OK      (1-based, value 0 clears)
+    //   UNDO <id> | REDO <id> | SOLVE <id>       -> OK
+    //   HINT <id>                                -> OK <row> <col> <value> | WRONG <row> <col> <value>
+    //   SHOW <id>                                -> OK <81 digits>
+    //   CLOSE <id>                               -> OK
+    //   STATS                                    -> OK <sessions> <bytes>
+    // Failures reply ERR <reason>. Returns 0, with nothing written, when NEW with a
+    // difficulty finds the stock empty; run the line again once it may have refilled.
+    size_t execute(const char *line, size_t length, char *reply);
+
+    static const char *resultName(SessionResult result);
+
+private:
+    struct Session
+    {
+        uint8_t cells[81];
+        uint8_t givens[SudokuBoard::CLUE_MASK_SIZE];   // Bit per cell
+        uint8_t solution[SudokuBoard::PACKED_SIZE];    // Valid when SOLUTION_KNOWN is set
+        uint8_t flags;
+        uint32_t generation;
+        SudokuMoveRing<HISTORY_SIZE, uint8_t> history;
+    };
+
+    // Session record for id, or nullptr if the id is stale
+    Session *find(SessionId id);
+    const Session *find(SessionId id) const;
+
+    // Solve on first use; false if the puzzle has no solution
+    bool ensureSolution(Session &session);
+
+    void applyMove(Session &session, const Move &move, bool forward);
+
+    static bool isGiven(const Session &session, int cell);
+
+    uint32_t maxSessions;
+    SudokuPuzzleBuffer *stock;
+    size_t activeSessions;
+    uint32_t allocatedSessions;
+    std::vector<std::unique_ptr<Session[]>> slabs;
+    std::vector<uint32_t> freeSlots;
+};
+
+#endif // SUDOKU_SESSION_MANAGER_HPP
@@ -0,0 +1,30 @@
+#ifndef SUDOKU_SESSION_SERVER_HPP
+#define SUDOKU_SESSION_SERVER_HPP
+
+#include "SudokuSessionManager.hpp"
+#include <atomic>
+#include <string>
+
+// Counters reported when the server stops
+struct SessionServerStats
+{
+    long long connections = 0;
+    long long commands = 0;
+    long long maxClients = 0;
+};
+
+// Unix-domain socket front end for SudokuSessionManager. One thread polls every
+// client and runs the newline-terminated text commands of
+// SudokuSessionManager::execute in arrival order; sessions are not tied to
+// connections, so a player can reconnect and carry on by id.
+class SudokuSessionServer
+{
+public:
+    static const size_t MAX_LINE = 256;
+
+    // Serve on path until stop becomes true (checked at least every pollMillis)
+    static bool run(const std::string &path, SudokuSessionManager &manager, const std::atomic<bool> &stop,
+                    SessionServerStats &stats, int pollMillis = 200);
+};
+
+#endif // SUDOKU_SESSION_SERVER_HPP
@@ -0,0 +1,48 @@
+#ifndef SUDOKU_SOCKET_HPP
+#define SUDOKU_SOCKET_HPP
+
+#include <cstddef>
+#include <string>
+
+// Thin wrappers over POSIX stream sockets for the local servers. Descriptors are
+// plain ints; every call returns -1 / false on failure. On Windows the calls are
+// stubs that always fail.
+class SudokuSocket
+{
+public:
+    // Bind and listen on a Unix-domain socket, replacing a stale socket file
+    static int listenUnix(const std::string &path, int backlog = 512);
+
+    static int connectUnix(const std::string &path);
+
+    // Listen on 127.0.0.1:port (loopback only; the servers are not meant to be exposed)
+    static int listenTcp(int port, int backlog = 512);
+
+    // Connect to host:port with Nagle disabled, since requests are small and latency-bound
+    static int connectTcp(const std::string &host, int port);
+
+    // Accept one pending connection (non-blocking on a non-blocking listener)
+    static int accept(int listener);
+
+    static bool setNonBlocking(int socket);
+
+    // Disable Nagle on a TCP socket; harmless no-op on Unix-domain sockets
+    static void setNoDelay(int socket);
+
+    // read()/write() that retry on EINTR; 0 from receive means the peer closed,
+    // -1 with wouldBlock set means try again later
+    static long receive(int socket, char *buffer, size_t size, bool &wouldBlock);
+    static long send(int socket, const char *data, size_t size, bool &wouldBlock);
+
+    // Send everything, blocking as needed
+    static bool sendAll(int socket, const char *data, size_t size);
+
+    static void close(int socket);
+
+    // Remove the socket file of a Unix-domain listener
+    static void unlinkPath(const std::string &path);
+
+    static bool isSupported();
+};
+
+#endif // SUDOKU_SOCKET_HPP
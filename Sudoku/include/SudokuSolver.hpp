@@ -2,22 +2,72 @@
 #define SUDOKU_SOLVER_HPP
 
 #include "SudokuBoard.hpp"
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Outcome of a solve attempt
+enum class SolveResult
+{
+    SOLVED,
+    DUPLICATE_GIVEN, // A digit is given twice in one unit
+    EMPTY_CELL,      // Propagation leaves a cell with no candidates
+    MISSING_DIGIT,   // Propagation leaves a digit with no place in a unit
+    NO_SOLUTION,     // Consistent under propagation, refuted by search
+    CANCELLED        // Search stopped by the caller
+};
+
+// Why a puzzle has no solution. givens lists cells (row * 9 + col) whose givens
+// alone already force the contradiction; removing any one of them lifts it.
+struct Contradiction
+{
+    SolveResult result = SolveResult::SOLVED;
+    int cell = -1; // EMPTY_CELL
+    int unit = -1; // DUPLICATE_GIVEN, MISSING_DIGIT (numbered as SudokuBits::UNITS)
+    int digit = 0;
+    std::vector<int> givens;
+};
+
+// Work done by one solve or count
+struct SolverStats
+{
+    long long nodes = 0; // Branches tried by the search
+};
 
 class SudokuSolver
 {
 public:
-    // Solve the sudoku puzzle using backtracking
+    // Solve the sudoku puzzle with constraint propagation and search
     static bool solve(SudokuBoard &board);
 
+    // Same, explaining failure. The board is only modified when solved. The search
+    // polls cancel (if given) at every node and returns CANCELLED once it is set;
+    // stats (if given) accumulates the nodes searched.
+    static SolveResult solve(SudokuBoard &board, Contradiction &contradiction,
+                             const std::atomic<bool> *cancel = nullptr, SolverStats *stats = nullptr);
+
+    // Cheap up-front check: duplicate givens, or a contradiction reached by naked and
+    // hidden singles alone. Fills in a minimal set of conflicting givens.
+    static bool findContradiction(const SudokuBoard &board, Contradiction &contradiction);
+
+    // One-line explanation for the user
+    static std::string describe(const SudokuBoard &board, const Contradiction &contradiction);
+
     // Check if the current board state is valid
     static bool isValidBoard(const SudokuBoard &board);
 
     // Find the next empty cell
     static bool findEmptyCell(const SudokuBoard &board, int &row, int &col);
 
-private:
-    // Recursive backtracking helper
-    static bool solveRecursive(SudokuBoard &board);
+    // Count solutions up to maxSolutions using bitmask search (fast uniqueness oracle).
+    // Polls cancel (if given) at every node; a count cut short that way means nothing.
+    static int countSolutions(const SudokuBoard &board, int maxSolutions = 2, SolverStats *stats = nullptr,
+                              const std::atomic<bool> *cancel = nullptr);
+
+    // True if the puzzle has a solution in which the empty cell (row, col) is not value.
+    // When value comes from a known solution this is a one-solution search instead of a
+    // two-solution count: the puzzle is unique exactly when this returns false.
+    static bool hasSolutionWithout(const SudokuBoard &board, int row, int col, int value);
 };
 
 #endif // SUDOKU_SOLVER_HPP
\ No newline at end of file
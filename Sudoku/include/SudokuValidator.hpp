@@ -0,0 +1,36 @@
+#ifndef SUDOKU_VALIDATOR_HPP
+#define SUDOKU_VALIDATOR_HPP
+
+#include <cstdint>
+#include <string>
+
+// Mask-based grid checks. Every unit is reduced to one 9-bit digit mask, so a
+// grid costs 27 reductions instead of a row/column/box scan per cell. Units are
+// numbered as SudokuBits::UNITS: 0-8 rows, 9-17 columns, 18-26 boxes.
+class SudokuValidator
+{
+public:
+    static const int VALID = -1;
+    static const int LANES = 16;
+
+    // First unit of a completed grid that is not a permutation of 1-9, or VALID
+    static int firstInvalidUnit(const uint8_t *cells);
+
+    // First unit of a partially filled grid (0 = blank) that repeats a digit, or VALID.
+    // Values above 9 count as a conflict in their row.
+    static int firstConflictingUnit(const uint8_t *cells);
+
+    // Validate count completed grids of 81 cells each. units[i] receives the
+    // firstInvalidUnit of grid i; returns the number of valid grids. Grids are
+    // checked LANES at a time with lane-wise masks.
+    static long long validate(const uint8_t *grids, long long count, int8_t *units);
+
+    // "row 3", "column 7", "box 1" (1-based for display)
+    static std::string unitName(int unit);
+
+private:
+    // Validate exactly LANES grids; returns the number of valid ones
+    static int validateLanes(const uint8_t *grids, int8_t *units);
+};
+
+#endif // SUDOKU_VALIDATOR_HPP
@@ -1,7 +1,292 @@
 #include "SudokuAdvancedChecks.hpp"
+#include "SudokuBits.hpp"
 #include <algorithm>
 #include <map>
 
+using namespace SudokuBits;
+
+namespace {
+    // Candidate masks for every cell, kept consistent as digits are placed
+    struct CandidateGrid {
+        uint8_t values[81];
+        uint16_t candidates[81];
+        int filled = 0;
+        bool broken = false;
+
+        void place(int cell, int digit) {
+            int bit = 1 << (digit - 1);
+            if (!(candidates[cell] & bit)) {
+                broken = true;
+                return;
+            }
+            values[cell] = static_cast<uint8_t>(digit);
+            candidates[cell] = 0;
+            filled++;
+            for (int peer : PEERS[cell]) {
+                candidates[peer] &= ~bit;
+            }
+        }
+
+        bool eliminate(int cell, int mask) {
+            if (!(candidates[cell] & mask)) {
+                return false;
+            }
+            candidates[cell] &= ~mask;
+            if (candidates[cell] == 0) {
+                broken = true;
+            }
+            return true;
+        }
+    };
+
+    void loadGrid(const SudokuBoard& board, CandidateGrid& grid) {
+        const auto& cells = board.getBoard();
+        for (int cell = 0; cell < 81; cell++) {
+            grid.values[cell] = 0;
+            grid.candidates[cell] = ALL_DIGITS;
+        }
+        for (int cell = 0; cell < 81 && !grid.broken; cell++) {
+            int value = cells[rowOf(cell)][colOf(cell)];
+            if (value != 0) {
+                grid.place(cell, value);
+            }
+        }
+    }
+
+    // Positions (unit indices 0-8) where each digit may still go in a unit
+    void digitPositions(const CandidateGrid& grid, const std::array<uint8_t, 9>& unit, int positions[9]) {
+        for (int d = 0; d < 9; d++) {
+            positions[d] = 0;
+        }
+        for (int i = 0; i < 9; i++) {
+            for (int m = grid.candidates[unit[i]]; m; m &= m - 1) {
+                positions[lowestBit(m)] |= 1 << i;
+            }
+        }
+    }
+
+    bool applyHiddenSingle(CandidateGrid& grid) {
+        for (const auto& unit : UNITS) {
+            int once = 0;
+            int twice = 0;
+            int placed = 0;
+            for (int cell : unit) {
+                twice |= once & grid.candidates[cell];
+                once |= grid.candidates[cell];
+                if (grid.values[cell]) {
+                    placed |= 1 << (grid.values[cell] - 1);
+                }
+            }
+            if ((once | placed) != ALL_DIGITS) {
+                grid.broken = true; // A digit has no place left in this unit
+                return false;
+            }
+
+            int single = once & ~twice;
+            if (single) {
+                for (int cell : unit) {
+                    if (grid.candidates[cell] & single) {
+                        grid.place(cell, lowestBit(grid.candidates[cell] & single) + 1);
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    bool applyNakedSingle(CandidateGrid& grid) {
+        for (int cell = 0; cell < 81; cell++) {
+            int mask = grid.candidates[cell];
+            if (mask && !(mask & (mask - 1))) {
+                grid.place(cell, lowestBit(mask) + 1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool applyLockedCandidates(CandidateGrid& grid) {
+        bool progress = false;
+
+        // Pointing: a digit confined to one line inside a box leaves the rest of that line.
+        // Claiming: a digit confined to one box inside a line leaves the rest of that box.
+        for (int box = 18; box < 27; box++) {
+            for (int line = 0; line < 18; line++) {
+                int inside = 0;
+                int boxOnly = 0;
+                int lineOnly = 0;
+                for (int cell : UNITS[box]) {
+                    bool onLine = line < 9 ? rowOf(cell) == line : colOf(cell) == line - 9;
+                    (onLine ? inside : boxOnly) |= grid.candidates[cell];
+                }
+                if (!inside) {
+                    continue;
+                }
+                for (int cell : UNITS[line]) {
+                    if (boxOf(cell) != box - 18) {
+                        lineOnly |= grid.candidates[cell];
+                    }
+                }
+
+                int pointing = inside & ~boxOnly & lineOnly;
+                int claiming = inside & ~lineOnly & boxOnly;
+                if (pointing) {
+                    for (int cell : UNITS[line]) {
+                        if (boxOf(cell) != box - 18) {
+                            progress |= grid.eliminate(cell, pointing);
+                        }
+                    }
+                }
+                if (claiming) {
+                    for (int cell : UNITS[box]) {
+                        bool onLine = line < 9 ? rowOf(cell) == line : colOf(cell) == line - 9;
+                        if (!onLine) {
+                            progress |= grid.eliminate(cell, claiming);
+                        }
+                    }
+                }
+                if (progress) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Naked subset: size cells of a unit whose candidates together hold exactly size digits
+    bool applyNakedSubset(CandidateGrid& grid, int size) {
+        for (const auto& unit : UNITS) {
+            for (int combo = 0; combo < 512; combo++) {
+                if (popCount(combo) != size) {
+                    continue;
+                }
+                int digits = 0;
+                bool allEmpty = true;
+                for (int i = 0; i < 9; i++) {
+                    if (combo & (1 << i)) {
+                        digits |= grid.candidates[unit[i]];
+                        allEmpty &= grid.candidates[unit[i]] != 0;
+                    }
+                }
+                if (!allEmpty || popCount(digits) != size) {
+                    continue;
+                }
+                bool progress = false;
+                for (int i = 0; i < 9; i++) {
+                    if (!(combo & (1 << i))) {
+                        progress |= grid.eliminate(unit[i], digits);
+                    }
+                }
+                if (progress) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Hidden subset: size digits of a unit that fit in exactly size cells
+    bool applyHiddenSubset(CandidateGrid& grid, int size) {
+        for (const auto& unit : UNITS) {
+            int positions[9];
+            digitPositions(grid, unit, positions);
+            for (int combo = 0; combo < 512; combo++) {
+                if (popCount(combo) != size) {
+                    continue;
+                }
+                int cells = 0;
+                bool allOpen = true;
+                for (int d = 0; d < 9; d++) {
+                    if (combo & (1 << d)) {
+                        cells |= positions[d];
+                        allOpen &= positions[d] != 0;
+                    }
+                }
+                if (!allOpen || popCount(cells) != size) {
+                    continue;
+                }
+                bool progress = false;
+                for (int i = 0; i < 9; i++) {
+                    if (cells & (1 << i)) {
+                        progress |= grid.eliminate(unit[i], ~combo & ALL_DIGITS);
+                    }
+                }
+                if (progress) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool applyXWing(CandidateGrid& grid) {
+        // Base lines are rows (units 0-8) then columns (units 9-17)
+        for (int base = 0; base < 18; base += 9) {
+            int cover = 9 - base;
+            for (int digit = 0; digit < 9; digit++) {
+                int bit = 1 << digit;
+                int positions[9];
+                for (int line = 0; line < 9; line++) {
+                    positions[line] = 0;
+                    for (int i = 0; i < 9; i++) {
+                        if (grid.candidates[UNITS[base + line][i]] & bit) {
+                            positions[line] |= 1 << i;
+                        }
+                    }
+                }
+                for (int a = 0; a < 9; a++) {
+                    if (popCount(positions[a]) != 2) {
+                        continue;
+                    }
+                    for (int b = a + 1; b < 9; b++) {
+                        if (positions[b] != positions[a]) {
+                            continue;
+                        }
+                        bool progress = false;
+                        for (int m = positions[a]; m; m &= m - 1) {
+                            for (int line = 0; line < 9; line++) {
+                                if (line != a && line != b) {
+                                    progress |= grid.eliminate(UNITS[cover + lowestBit(m)][line], bit);
+                                }
+                            }
+                        }
+                        if (progress) {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    bool applyTechnique(CandidateGrid& grid, Technique technique) {
+        switch (technique) {
+            case Technique::HIDDEN_SINGLE: return applyHiddenSingle(grid);
+            case Technique::NAKED_SINGLE: return applyNakedSingle(grid);
+            case Technique::LOCKED_CANDIDATES: return applyLockedCandidates(grid);
+            case Technique::NAKED_PAIR: return applyNakedSubset(grid, 2);
+            case Technique::X_WING: return applyXWing(grid);
+            case Technique::HIDDEN_PAIR: return applyHiddenSubset(grid, 2);
+            case Technique::NAKED_TRIPLE: return applyNakedSubset(grid, 3);
+            case Technique::HIDDEN_TRIPLE: return applyHiddenSubset(grid, 3);
+            default: return false;
+        }
+    }
+
+    const Technique TECHNIQUE_LADDER[] = {
+        Technique::HIDDEN_SINGLE,
+        Technique::NAKED_SINGLE,
+        Technique::LOCKED_CANDIDATES,
+        Technique::NAKED_PAIR,
+        Technique::X_WING,
+        Technique::HIDDEN_PAIR,
+        Technique::NAKED_TRIPLE,
+        Technique::HIDDEN_TRIPLE,
+    };
+}
+
 std::set<int> SudokuAdvancedChecks::getPossibleValues(const SudokuBoard& board, int row, int col) {
     std::set<int> possible;
     
@@ -218,4 +503,75 @@ bool SudokuAdvancedChecks::isOnlyPossibilityInUnit(const SudokuBoard& board, int
     // Check if this is the only cell in row/col/box that can contain this value
     // Simplified implementation
     return false;
+}
+
+int SudokuAdvancedChecks::techniqueScore(Technique technique) {
+    switch (technique) {
+        case Technique::HIDDEN_SINGLE: return 15;
+        case Technique::NAKED_SINGLE: return 23;
+        case Technique::LOCKED_CANDIDATES: return 28;
+        case Technique::NAKED_PAIR: return 30;
+        case Technique::X_WING: return 32;
+        case Technique::HIDDEN_PAIR: return 34;
+        case Technique::NAKED_TRIPLE: return 36;
+        case Technique::HIDDEN_TRIPLE: return 40;
+        case Technique::SEARCH: return 70;
+        default: return 0;
+    }
+}
+
+const char* SudokuAdvancedChecks::techniqueName(Technique technique) {
+    switch (technique) {
+        case Technique::HIDDEN_SINGLE: return "hidden-single";
+        case Technique::NAKED_SINGLE: return "naked-single";
+        case Technique::LOCKED_CANDIDATES: return "locked-candidates";
+        case Technique::NAKED_PAIR: return "naked-pair";
+        case Technique::X_WING: return "x-wing";
+        case Technique::HIDDEN_PAIR: return "hidden-pair";
+        case Technique::NAKED_TRIPLE: return "naked-triple";
+        case Technique::HIDDEN_TRIPLE: return "hidden-triple";
+        case Technique::SEARCH: return "search";
+        default: return "none";
+    }
+}
+
+PuzzleRating SudokuAdvancedChecks::ratePuzzle(const SudokuBoard& board, int ceiling) {
+    PuzzleRating rating;
+    CandidateGrid grid;
+    loadGrid(board, grid);
+
+    while (grid.filled < 81 && !grid.broken) {
+        Technique used = Technique::SEARCH;
+        for (Technique technique : TECHNIQUE_LADDER) {
+            if (techniqueScore(technique) > ceiling) {
+                // Everything cheaper is exhausted; the puzzle is over the ceiling
+                rating.score = techniqueScore(technique);
+                rating.hardest = technique;
+                return rating;
+            }
+            if (applyTechnique(grid, technique)) {
+                used = technique;
+                break;
+            }
+            if (grid.broken) {
+                break;
+            }
+        }
+        if (grid.broken) {
+            break;
+        }
+
+        if (techniqueScore(used) > rating.score) {
+            rating.score = techniqueScore(used);
+            rating.hardest = used;
+        }
+        if (used == Technique::SEARCH) {
+            return rating;
+        }
+        rating.steps++;
+    }
+
+    rating.consistent = !grid.broken;
+    rating.solved = !grid.broken && grid.filled == 81;
+    return rating;
 }
\ No newline at end of file
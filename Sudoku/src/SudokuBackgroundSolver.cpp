@@ -0,0 +1,89 @@
+#include "SudokuBackgroundSolver.hpp"
+
+SudokuBackgroundSolver::SudokuBackgroundSolver()
+    : cancelRequested(false), currentStatus(SolutionStatus::NONE), cells(), unique(false)
+{
+}
+
+SudokuBackgroundSolver::~SudokuBackgroundSolver()
+{
+    cancel();
+}
+
+void SudokuBackgroundSolver::start(const SudokuBoard &puzzle)
+{
+    cancel();
+
+    cancelRequested.store(false, std::memory_order_relaxed);
+    currentStatus.store(SolutionStatus::PENDING, std::memory_order_release);
+    worker = std::thread(&SudokuBackgroundSolver::solveInBackground, this, puzzle);
+}
+
+void SudokuBackgroundSolver::cancel()
+{
+    if (worker.joinable())
+    {
+        cancelRequested.store(true, std::memory_order_relaxed);
+        worker.join();
+    }
+    if (currentStatus.load(std::memory_order_relaxed) == SolutionStatus::PENDING)
+    {
+        currentStatus.store(SolutionStatus::NONE, std::memory_order_release);
+    }
+}
+
+int SudokuBackgroundSolver::value(int row, int col) const
+{
+    if (status() != SolutionStatus::READY)
+    {
+        return 0;
+    }
+    return cells[row * 9 + col];
+}
+
+bool SudokuBackgroundSolver::solution(SudokuBoard &board) const
+{
+    if (status() != SolutionStatus::READY)
+    {
+        return false;
+    }
+
+    auto &rows = board.getBoard();
+    for (int cell = 0; cell < 81; cell++)
+    {
+        rows[cell / 9][cell % 9] = cells[cell];
+    }
+    return true;
+}
+
+void SudokuBackgroundSolver::solveInBackground(SudokuBoard puzzle)
+{
+    SudokuBoard solved = puzzle;
+    Contradiction contradiction;
+    SolveResult result = SudokuSolver::solve(solved, contradiction, &cancelRequested);
+    if (result == SolveResult::CANCELLED)
+    {
+        return;
+    }
+
+    if (result != SolveResult::SOLVED)
+    {
+        failure = contradiction;
+        currentStatus.store(SolutionStatus::UNSOLVABLE, std::memory_order_release);
+        return;
+    }
+
+    const auto &rows = solved.getBoard();
+    for (int cell = 0; cell < 81; cell++)
+    {
+        cells[cell] = static_cast<uint8_t>(rows[cell / 9][cell % 9]);
+    }
+
+    // With a second solution, move checks can only compare against one of them
+    unique = SudokuSolver::countSolutions(puzzle, 2, nullptr, &cancelRequested) == 1;
+    if (cancelRequested.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    currentStatus.store(SolutionStatus::READY, std::memory_order_release);
+}
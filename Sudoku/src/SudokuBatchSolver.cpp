@@ -0,0 +1,184 @@
+#include "SudokuBatchSolver.hpp"
+#include "SudokuBits.hpp"
+#include "SudokuBoard.hpp"
+#include "SudokuSolver.hpp"
+#include <cstring>
+
+using namespace SudokuBits;
+
+namespace
+{
+    const int LANES = SudokuBatchSolver::LANES;
+
+    // Candidate masks of every cell, one column per puzzle
+    struct LaneGrid
+    {
+        alignas(32) uint16_t candidates[81][LANES];
+    };
+
+    // Lane-wise helpers; each loop runs over all lanes with no data-dependent branches
+    inline void singles(const uint16_t *x, uint16_t *single)
+    {
+        for (int l = 0; l < LANES; l++)
+        {
+            single[l] = (x[l] & (x[l] - 1)) == 0 ? x[l] : 0;
+        }
+    }
+
+    // One round of naked and hidden singles over every unit. Sets changed for lanes
+    // whose masks moved and broken for lanes that hit a contradiction.
+    void propagateRound(LaneGrid &grid, uint16_t *changed, uint16_t *broken)
+    {
+        for (const auto &unit : UNITS)
+        {
+            alignas(32) uint16_t solved[LANES] = {0};
+            alignas(32) uint16_t duplicate[LANES] = {0};
+            alignas(32) uint16_t single[LANES];
+
+            // Digits already fixed in the unit, and any digit fixed twice
+            for (int cell : unit)
+            {
+                singles(grid.candidates[cell], single);
+                for (int l = 0; l < LANES; l++)
+                {
+                    duplicate[l] |= solved[l] & single[l];
+                    solved[l] |= single[l];
+                }
+            }
+
+            // Naked singles: strip fixed digits from the other cells
+            alignas(32) uint16_t once[LANES] = {0};
+            alignas(32) uint16_t twice[LANES] = {0};
+            for (int cell : unit)
+            {
+                uint16_t *x = grid.candidates[cell];
+                singles(x, single);
+                for (int l = 0; l < LANES; l++)
+                {
+                    uint16_t next = single[l] ? x[l] : static_cast<uint16_t>(x[l] & ~solved[l]);
+                    changed[l] |= next ^ x[l];
+                    broken[l] |= next == 0;
+                    x[l] = next;
+                    twice[l] |= once[l] & next;
+                    once[l] |= next;
+                }
+            }
+
+            // Hidden singles: a digit with one possible cell goes there
+            alignas(32) uint16_t hidden[LANES];
+            for (int l = 0; l < LANES; l++)
+            {
+                broken[l] |= duplicate[l] | (once[l] ^ ALL_DIGITS);
+                hidden[l] = once[l] & ~twice[l] & ~solved[l];
+            }
+            for (int cell : unit)
+            {
+                uint16_t *x = grid.candidates[cell];
+                for (int l = 0; l < LANES; l++)
+                {
+                    uint16_t only = x[l] & hidden[l];
+                    uint16_t next = only ? only : x[l];
+                    changed[l] |= next ^ x[l];
+                    x[l] = next;
+                }
+            }
+        }
+    }
+}
+
+void SudokuBatchSolver::solve(const uint8_t *puzzles, int count, uint8_t *solutions, BatchResult *results,
+                              BatchSolveStats *stats)
+{
+    for (int start = 0; start < count; start += LANES)
+    {
+        int lanes = count - start < LANES ? count - start : LANES;
+        solveLanes(puzzles + start * 81, lanes, solutions + start * 81, results + start);
+    }
+
+    if (stats != nullptr)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            stats->propagated += results[i] == BatchResult::PROPAGATED;
+            stats->searched += results[i] == BatchResult::SEARCHED;
+            stats->unsolvable += results[i] == BatchResult::UNSOLVABLE;
+        }
+    }
+}
+
+void SudokuBatchSolver::solveLanes(const uint8_t *puzzles, int count, uint8_t *solutions, BatchResult *results)
+{
+    LaneGrid grid;
+    for (int cell = 0; cell < 81; cell++)
+    {
+        for (int l = 0; l < LANES; l++)
+        {
+            // Unused lanes get an already solved-looking cell so they settle at once
+            int value = l < count ? puzzles[l * 81 + cell] : 1 + (cell % 9 + cell / 9 * 3 + cell / 27) % 9;
+            grid.candidates[cell][l] = static_cast<uint16_t>(value ? 1 << (value - 1) : ALL_DIGITS);
+        }
+    }
+
+    alignas(32) uint16_t broken[LANES] = {0};
+    alignas(32) uint16_t changed[LANES];
+    bool anyChanged = true;
+    while (anyChanged)
+    {
+        std::memset(changed, 0, sizeof(changed));
+        propagateRound(grid, changed, broken);
+
+        anyChanged = false;
+        for (int l = 0; l < LANES; l++)
+        {
+            anyChanged |= changed[l] != 0 && broken[l] == 0;
+        }
+    }
+
+    SudokuBoard board;
+    for (int l = 0; l < count; l++)
+    {
+        const uint8_t *puzzle = puzzles + l * 81;
+        uint8_t *solution = solutions + l * 81;
+
+        if (broken[l])
+        {
+            std::memcpy(solution, puzzle, 81);
+            results[l] = BatchResult::UNSOLVABLE;
+            continue;
+        }
+
+        bool complete = true;
+        for (int cell = 0; cell < 81; cell++)
+        {
+            uint16_t x = grid.candidates[cell][l];
+            bool fixed = (x & (x - 1)) == 0;
+            complete &= fixed;
+            solution[cell] = static_cast<uint8_t>(fixed ? lowestBit(x) + 1 : 0);
+        }
+        if (complete)
+        {
+            results[l] = BatchResult::PROPAGATED;
+            continue;
+        }
+
+        // Continue from the propagated state in the scalar solver
+        auto &rows = board.getBoard();
+        for (int cell = 0; cell < 81; cell++)
+        {
+            rows[cell / 9][cell % 9] = solution[cell];
+        }
+        if (SudokuSolver::solve(board))
+        {
+            for (int cell = 0; cell < 81; cell++)
+            {
+                solution[cell] = static_cast<uint8_t>(rows[cell / 9][cell % 9]);
+            }
+            results[l] = BatchResult::SEARCHED;
+        }
+        else
+        {
+            std::memcpy(solution, puzzle, 81);
+            results[l] = BatchResult::UNSOLVABLE;
+        }
+    }
+}
@@ -1,7 +1,14 @@
 #include "SudokuBoard.hpp"
+#include "SudokuBits.hpp"
+#include "SudokuRenderer.hpp"
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 
+#ifdef SUDOKU_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
 SudokuBoard::SudokuBoard() : board(BOARD_SIZE, std::vector<int>(BOARD_SIZE, 0)) {}
 
 void SudokuBoard::initializeBoard(const std::vector<std::vector<int>> &initialBoard)
@@ -60,34 +67,8 @@ bool SudokuBoard::isEmpty(int row, int col) const
 
 void SudokuBoard::printBoard() const
 {
-    std::cout << "-------------------------------------\n";
-
-    for (int i = 0; i < BOARD_SIZE; i++)
-    {
-        for (int j = 0; j < BOARD_SIZE; j++)
-        {
-            if (board[i][j] == 0)
-            {
-                std::cout << ". ";
-            }
-            else
-            {
-                std::cout << board[i][j] << " ";
-            }
-
-            if (j % BOX_SIZE == BOX_SIZE - 1 && j != BOARD_SIZE - 1)
-            {
-                std::cout << "| ";
-            }
-        }
-        std::cout << "\n";
-
-        if (i % BOX_SIZE == BOX_SIZE - 1 && i != BOARD_SIZE - 1)
-        {
-            std::cout << "-------------------------------------\n";
-        }
-    }
-    std::cout << "-------------------------------------\n";
+    SudokuRenderer renderer(RenderMode::PLAIN);
+    renderer.render(*this);
 }
 
 bool SudokuBoard::loadFromFile(const std::string &filename)
@@ -138,6 +119,154 @@ bool SudokuBoard::saveToFile(const std::string &filename) const
     return true;
 }
 
+void SudokuBoard::formatLine(char *line) const
+{
+    for (int i = 0; i < BOARD_SIZE; i++)
+    {
+        const int *row = board[i].data();
+        for (int j = 0; j < BOARD_SIZE; j++)
+        {
+            line[i * BOARD_SIZE + j] = row[j] == 0 ? '.' : static_cast<char>('0' + row[j]);
+        }
+    }
+}
+
+void SudokuBoard::packCells(const unsigned char *cells, unsigned char *packed)
+{
+    // Pad to whole blocks: the 82nd nibble is zero
+    unsigned char padded[96] = {0};
+    std::memcpy(padded, cells, 81);
+
+#ifdef SUDOKU_HAS_SSE2
+    unsigned char out[48];
+    const __m128i lowByte = _mm_set1_epi16(0x00FF);
+    for (int block = 0; block < 3; block++)
+    {
+        // Each 16-bit lane holds (even cell, odd cell); fold it into one byte
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(padded + block * 32));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(padded + block * 32 + 16));
+        a = _mm_or_si128(_mm_and_si128(a, lowByte), _mm_slli_epi16(_mm_srli_epi16(a, 8), 4));
+        b = _mm_or_si128(_mm_and_si128(b, lowByte), _mm_slli_epi16(_mm_srli_epi16(b, 8), 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + block * 16), _mm_packus_epi16(a, b));
+    }
+    std::memcpy(packed, out, PACKED_SIZE);
+#else
+    for (int k = 0; k < PACKED_SIZE; k++)
+    {
+        packed[k] = static_cast<unsigned char>((padded[2 * k] & 0xF) | (padded[2 * k + 1] << 4));
+    }
+#endif
+}
+
+bool SudokuBoard::unpackCells(const unsigned char *packed, unsigned char *cells)
+{
+    unsigned char padded[48] = {0};
+    std::memcpy(padded, packed, PACKED_SIZE);
+
+#ifdef SUDOKU_HAS_SSE2
+    unsigned char out[96];
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i over = _mm_setzero_si128();
+    for (int block = 0; block < 3; block++)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(padded + block * 16));
+        __m128i low = _mm_and_si128(bytes, nibble);
+        __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble);
+        __m128i first = _mm_unpacklo_epi8(low, high);
+        __m128i second = _mm_unpackhi_epi8(low, high);
+
+        // A digit above 9 survives max(x, 9) != 9
+        over = _mm_or_si128(over, _mm_max_epu8(first, _mm_set1_epi8(9)));
+        over = _mm_or_si128(over, _mm_max_epu8(second, _mm_set1_epi8(9)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + block * 32), first);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + block * 32 + 16), second);
+    }
+    std::memcpy(cells, out, 81);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(over, _mm_set1_epi8(9))) == 0xFFFF;
+#else
+    int invalid = 0;
+    for (int k = 0; k < PACKED_SIZE; k++)
+    {
+        unsigned char low = padded[k] & 0xF;
+        unsigned char high = padded[k] >> 4;
+        invalid |= (low > 9) | (high > 9);
+        cells[2 * k] = low;
+        if (2 * k + 1 < 81)
+        {
+            cells[2 * k + 1] = high;
+        }
+    }
+    return !invalid;
+#endif
+}
+
+void SudokuBoard::encodePacked(unsigned char *packed) const
+{
+    unsigned char cells[81];
+    for (int i = 0; i < BOARD_SIZE; i++)
+    {
+        const int *row = board[i].data();
+        for (int j = 0; j < BOARD_SIZE; j++)
+        {
+            cells[i * BOARD_SIZE + j] = static_cast<unsigned char>(row[j] & 0xF);
+        }
+    }
+    packCells(cells, packed);
+}
+
+bool SudokuBoard::decodePacked(const unsigned char *packed)
+{
+    unsigned char cells[81];
+    bool valid = unpackCells(packed, cells);
+    for (int i = 0; i < BOARD_SIZE; i++)
+    {
+        int *row = board[i].data();
+        for (int j = 0; j < BOARD_SIZE; j++)
+        {
+            row[j] = cells[i * BOARD_SIZE + j];
+        }
+    }
+    return valid;
+}
+
+bool SudokuBoard::encodeClueMask(const SudokuBoard &solution, unsigned char *mask) const
+{
+    int mismatch = 0;
+    for (int k = 0; k < CLUE_MASK_SIZE; k++)
+    {
+        mask[k] = 0;
+    }
+
+    for (int i = 0; i < BOARD_SIZE; i++)
+    {
+        const int *row = board[i].data();
+        const int *solved = solution.board[i].data();
+        for (int j = 0; j < BOARD_SIZE; j++)
+        {
+            int cell = i * BOARD_SIZE + j;
+            int given = row[j] != 0;
+            mismatch |= given & (row[j] != solved[j]);
+            mask[cell >> 3] |= static_cast<unsigned char>(given << (cell & 7));
+        }
+    }
+    return !mismatch;
+}
+
+void SudokuBoard::decodeClueMask(const SudokuBoard &solution, const unsigned char *mask)
+{
+    for (int i = 0; i < BOARD_SIZE; i++)
+    {
+        int *row = board[i].data();
+        const int *solved = solution.board[i].data();
+        for (int j = 0; j < BOARD_SIZE; j++)
+        {
+            int cell = i * BOARD_SIZE + j;
+            int given = (mask[cell >> 3] >> (cell & 7)) & 1;
+            row[j] = solved[j] & -given;
+        }
+    }
+}
+
 bool SudokuBoard::isFull() const
 {
     for (int i = 0; i < BOARD_SIZE; i++)
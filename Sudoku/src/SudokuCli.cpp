@@ -0,0 +1,1226 @@
+#include "SudokuCli.hpp"
+#include "SudokuAdvancedChecks.hpp"
+#include "SudokuBatchSolver.hpp"
+#include "SudokuConstraints.hpp"
+#include "SudokuGridGenerator.hpp"
+#include "SudokuGridTechniques.hpp"
+#include "SudokuGridValidator.hpp"
+#include "SudokuHistogram.hpp"
+#include "SudokuJigsaw.hpp"
+#include "SudokuKillerGenerator.hpp"
+#include "SudokuKillerSolver.hpp"
+#include "SudokuLineReader.hpp"
+#include "SudokuPuzzleBank.hpp"
+#include "SudokuPuzzleBuffer.hpp"
+#include "SudokuSamurai.hpp"
+#include "SudokuService.hpp"
+#include "SudokuSessionServer.hpp"
+#include "SudokuSocket.hpp"
+#include "SudokuSolver.hpp"
+#include "SudokuValidator.hpp"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const size_t OUTPUT_BUFFER_SIZE = 1 << 22;
+    const int BATCH_SIZE = 256;
+    const char *const SERVE_SOCKET = "sudoku.sock";
+    const int SERVE_STOCK = 16; // Default puzzles per difficulty kept ready by serve
+    const char *const SERVICE_SOCKET = "sudoku-service.sock";
+
+    std::vector<char> outputBuffer;
+
+    // Raised by SIGINT/SIGTERM to stop the servers cleanly
+    std::atomic<bool> stopRequested(false);
+
+    void requestStop(int)
+    {
+        stopRequested.store(true);
+    }
+
+    void installStopHandlers()
+    {
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+#ifdef SIGPIPE
+        std::signal(SIGPIPE, SIG_IGN);
+#endif
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool parseDifficulty(const std::string &name, Difficulty &difficulty)
+    {
+        if (name == "easy")
+            difficulty = Difficulty::EASY;
+        else if (name == "medium")
+            difficulty = Difficulty::MEDIUM;
+        else if (name == "hard")
+            difficulty = Difficulty::HARD;
+        else
+            return false;
+        return true;
+    }
+
+    bool parseSymmetry(const std::string &name, Symmetry &symmetry)
+    {
+        if (name == "none")
+            symmetry = Symmetry::NONE;
+        else if (name == "180")
+            symmetry = Symmetry::ROTATIONAL_180;
+        else if (name == "90")
+            symmetry = Symmetry::ROTATIONAL_90;
+        else if (name == "diagonal")
+            symmetry = Symmetry::DIAGONAL;
+        else if (name == "mirror")
+            symmetry = Symmetry::MIRROR;
+        else
+            return false;
+        return true;
+    }
+
+    // Append text after an 81-character puzzle already in out; returns the new length
+    int appendText(char *out, int length, const char *text)
+    {
+        size_t size = std::strlen(text);
+        std::memcpy(out + length, text, size);
+        return length + static_cast<int>(size);
+    }
+}
+
+bool SudokuCli::isCommand(const std::string &name)
+{
+    return name == "solve" || name == "generate" || name == "rate" || name == "validate" || name == "count" ||
+           name == "serve" || name == "service" || name == "loadtest";
+}
+
+void SudokuCli::printUsage()
+{
+    std::cerr << "Usage: SudokuProject <command> [options]\n"
+              << "Commands:\n"
+              << "  solve      Solve each puzzle\n"
+              << "  generate   Generate new puzzles\n"
+              << "  rate       Grade each puzzle by the hardest technique it needs\n"
+              << "  validate   Check each grid for rule violations and completeness\n"
+              << "  count      Count solutions of each puzzle\n"
+              << "  serve      Host game sessions on a Unix-domain socket\n"
+              << "  service    Answer solve/generate/rate requests on a socket\n"
+              << "  loadtest   Drive a running service and report latency percentiles\n"
+              << "Options:\n"
+              << "  -i FILE             Read puzzles from FILE (default stdin)\n"
+              << "  -o FILE             Write results to FILE (default stdout)\n"
+              << "  -q                  Do not print throughput stats\n"
+              << "  -t N                Worker threads for solve/rate/validate/count/service,\n"
+              << "                      client connections for loadtest (0 = all cores)\n"
+              << "  -n N                generate: number of puzzles; loadtest: requests (default 1)\n"
+              << "  -d LEVEL            generate, loadtest: easy, medium or hard (default medium)\n"
+              << "  --rated             generate: target the grader band of the difficulty\n"
+              << "  --symmetry KIND     generate: none, 180, 90, diagonal or mirror\n"
+              << "  --seed N            generate: random seed\n"
+              << "  --bank FILE         generate: also write a binary puzzle bank;\n"
+              << "                      serve, service: take generated puzzles from this bank\n"
+              << "  --limit N           count: stop counting at N solutions (default 2)\n"
+              << "  --box RxC           solve, generate, rate, validate, count: box shape 2x2, 2x3, 3x3,\n"
+              << "                      3x4, 4x4 or 5x5\n"
+              << "  --variant KIND      solve, generate, rate, validate, count: 9x9 with extra rules, one of\n"
+              << "                      x (diagonals), windoku, antiknight, antiking, killer, jigsaw\n"
+              << "                      or samurai (five overlapping grids, 369 cells)\n"
+              << "  --layout FILE       jigsaw: region layout, 81 labels with 9 distinct ones\n"
+              << "  --socket PATH       serve: socket path (default sudoku.sock);\n"
+              << "                      service, loadtest: socket path (default sudoku-service.sock)\n"
+              << "  --sessions N        serve: maximum concurrent sessions (default 1048576)\n"
+              << "  --port N            service, loadtest: use TCP on 127.0.0.1:N\n"
+              << "  --batch N           service: most requests a worker takes at once (default 64)\n"
+              << "  --buffer N          service, serve: keep N generated puzzles per difficulty ready\n"
+              << "                      (serve default 16)\n"
+              << "  --request KIND      loadtest: solve, rate or generate (default solve)\n"
+              << "Puzzles are 81-character lines with '.' or '0' for blanks (one character per cell,\n"
+              << "with A, B, ... for 10 and up, on larger grids).\n";
+}
+
+bool SudokuCli::parseOptions(int argc, char *argv[], Options &options)
+{
+    options.command = argv[1];
+
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "-q")
+        {
+            options.quiet = true;
+        }
+        else if (arg == "--rated")
+        {
+            options.rated = true;
+        }
+        else if (!hasValue)
+        {
+            std::cerr << "Missing value or unknown option: " << arg << "\n";
+            return false;
+        }
+        else if (arg == "-i")
+        {
+            options.input = argv[++i];
+        }
+        else if (arg == "-o")
+        {
+            options.output = argv[++i];
+        }
+        else if (arg == "-n")
+        {
+            options.count = std::atoll(argv[++i]);
+        }
+        else if (arg == "-d")
+        {
+            if (!parseDifficulty(argv[++i], options.difficulty))
+            {
+                std::cerr << "Unknown difficulty: " << argv[i] << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--symmetry")
+        {
+            if (!parseSymmetry(argv[++i], options.symmetry))
+            {
+                std::cerr << "Unknown symmetry: " << argv[i] << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--seed")
+        {
+            options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--bank")
+        {
+            options.bank = argv[++i];
+        }
+        else if (arg == "-t")
+        {
+            options.threads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--limit")
+        {
+            options.limit = std::atoi(argv[++i]);
+        }
+        else if (arg == "--socket")
+        {
+            options.socket = argv[++i];
+        }
+        else if (arg == "--sessions")
+        {
+            options.sessions = std::atoll(argv[++i]);
+        }
+        else if (arg == "--box")
+        {
+            if (std::sscanf(argv[++i], "%dx%d", &options.boxRows, &options.boxCols) != 2)
+            {
+                std::cerr << "Box shape must look like 4x4: " << argv[i] << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--variant")
+        {
+            options.variant = argv[++i];
+            if (options.variant != "x" && options.variant != "windoku" && options.variant != "antiknight" &&
+                options.variant != "antiking" && options.variant != "killer" && options.variant != "jigsaw" &&
+                options.variant != "samurai")
+            {
+                std::cerr << "Unknown variant: " << options.variant << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--layout")
+        {
+            options.layout = argv[++i];
+        }
+        else if (arg == "--port")
+        {
+            options.port = std::atoi(argv[++i]);
+        }
+        else if (arg == "--batch")
+        {
+            options.batch = std::atoi(argv[++i]);
+        }
+        else if (arg == "--buffer")
+        {
+            options.buffer = std::atoi(argv[++i]);
+        }
+        else if (arg == "--request")
+        {
+            options.request = argv[++i];
+            if (options.request != "solve" && options.request != "rate" && options.request != "generate")
+            {
+                std::cerr << "Unknown request: " << options.request << "\n";
+                return false;
+            }
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+
+    return options.count >= 0 && options.limit > 0 && options.threads >= 0 && options.sessions > 0 &&
+           options.sessions <= 0xFFFFFFFFLL && options.port >= 0 && options.port <= 65535 && options.batch > 0 &&
+           options.buffer >= 0;
+}
+
+std::FILE *SudokuCli::openOutput(const Options &options)
+{
+    std::FILE *out = options.output.empty() ? stdout : std::fopen(options.output.c_str(), "wb");
+    if (out == nullptr)
+    {
+        std::cerr << "Cannot open output file: " << options.output << "\n";
+        return nullptr;
+    }
+
+    outputBuffer.resize(OUTPUT_BUFFER_SIZE);
+    std::setvbuf(out, outputBuffer.data(), _IOFBF, outputBuffer.size());
+    return out;
+}
+
+long long SudokuCli::streamPuzzles(const Options &options, std::FILE *out, const LineHandler &handler)
+{
+    SudokuLineReader reader;
+    bool opened = options.input.empty() ? reader.open(stdin) : reader.open(options.input);
+    if (!opened)
+    {
+        std::cerr << "Cannot open input file: " << options.input << "\n";
+        return -1;
+    }
+
+    if (options.threads != 1)
+    {
+        PipelineOptions pipelineOptions;
+        pipelineOptions.workers = options.threads;
+
+        PipelineStats stats;
+        bool ok = SudokuPipeline::run(reader, out, handler, pipelineOptions, stats);
+        if (!options.quiet)
+        {
+            if (stats.invalidLines > 0)
+            {
+                std::cerr << "Skipped " << stats.invalidLines << " malformed line(s)\n";
+            }
+            std::cerr << stats.summary() << "\n";
+        }
+        return ok ? stats.puzzles : -1;
+    }
+
+    SudokuBoard board;
+    uint8_t cells[81];
+    char line[81];
+    char result[SudokuPipeline::MAX_RESULT_LENGTH + 1];
+    long long puzzles = 0;
+
+    while (reader.next(cells))
+    {
+        auto &rows = board.getBoard();
+        for (int i = 0; i < 81; i++)
+        {
+            rows[i / 9][i % 9] = cells[i];
+            line[i] = cells[i] == 0 ? '.' : static_cast<char>('0' + cells[i]);
+        }
+
+        int length = handler(board, line, result);
+        result[length++] = '\n';
+        std::fwrite(result, 1, length, out);
+        puzzles++;
+    }
+
+    if (reader.invalidLines() > 0 && !options.quiet)
+    {
+        std::cerr << "Skipped " << reader.invalidLines() << " malformed line(s)\n";
+    }
+    return puzzles;
+}
+
+long long SudokuCli::streamBatches(const Options &options, std::FILE *out,
+                                  const SudokuPipeline::BatchHandler &handler)
+{
+    SudokuLineReader reader;
+    bool opened = options.input.empty() ? reader.open(stdin) : reader.open(options.input);
+    if (!opened)
+    {
+        std::cerr << "Cannot open input file: " << options.input << "\n";
+        return -1;
+    }
+
+    if (options.threads != 1)
+    {
+        PipelineOptions pipelineOptions;
+        pipelineOptions.workers = options.threads;
+        pipelineOptions.batchSize = BATCH_SIZE;
+
+        PipelineStats stats;
+        bool ok = SudokuPipeline::run(reader, out, handler, pipelineOptions, stats);
+        if (!options.quiet)
+        {
+            if (stats.invalidLines > 0)
+            {
+                std::cerr << "Skipped " << stats.invalidLines << " malformed line(s)\n";
+            }
+            std::cerr << stats.summary() << "\n";
+        }
+        return ok ? stats.puzzles : -1;
+    }
+
+    std::vector<uint8_t> cells(BATCH_SIZE * 81);
+    std::vector<char> results(BATCH_SIZE * SudokuPipeline::MAX_RESULT_LENGTH);
+    std::vector<int> lengths(BATCH_SIZE);
+    long long puzzles = 0;
+
+    bool more = true;
+    while (more)
+    {
+        int count = 0;
+        while (count < BATCH_SIZE && (more = reader.next(&cells[count * 81])))
+        {
+            count++;
+        }
+        if (count == 0)
+        {
+            break;
+        }
+
+        handler(cells.data(), count, results.data(), lengths.data());
+        for (int i = 0; i < count; i++)
+        {
+            std::fwrite(&results[i * SudokuPipeline::MAX_RESULT_LENGTH], 1, lengths[i], out);
+            std::fputc('\n', out);
+        }
+        puzzles += count;
+    }
+
+    if (reader.invalidLines() > 0 && !options.quiet)
+    {
+        std::cerr << "Skipped " << reader.invalidLines() << " malformed line(s)\n";
+    }
+    return puzzles;
+}
+
+void SudokuCli::printStats(const Options &options, long long puzzles, double seconds, const std::string &extra)
+{
+    if (options.quiet)
+    {
+        return;
+    }
+
+    double rate = seconds > 0 ? puzzles / seconds : 0.0;
+    char text[160];
+    std::snprintf(text, sizeof(text), "%s: %lld puzzles in %.3f s (%.0f puzzles/s, %.2f us/puzzle)",
+                  options.command.c_str(), puzzles, seconds, rate, puzzles > 0 ? seconds * 1e6 / puzzles : 0.0);
+    std::cerr << text << extra << "\n";
+}
+
+int SudokuCli::runSolve(const Options &options)
+{
+    std::FILE *out = openOutput(options);
+    if (out == nullptr)
+    {
+        return 1;
+    }
+
+    // Easy puzzles finish in the batch solver's SIMD lanes; the rest fall back to search
+    std::atomic<long long> propagated(0);
+    std::atomic<long long> searched(0);
+    std::atomic<long long> unsolved(0);
+    auto start = std::chrono::steady_clock::now();
+    long long puzzles = streamBatches(options, out, [&](const uint8_t *cells, int count, char *results, int *lengths)
+    {
+        std::vector<uint8_t> solutions(count * 81);
+        std::vector<BatchResult> outcomes(count);
+        BatchSolveStats batchStats;
+        SudokuBatchSolver::solve(cells, count, solutions.data(), outcomes.data(), &batchStats);
+
+        for (int i = 0; i < count; i++)
+        {
+            char *result = results + i * SudokuPipeline::MAX_RESULT_LENGTH;
+            const uint8_t *grid = &solutions[i * 81];
+            for (int k = 0; k < 81; k++)
+            {
+                result[k] = grid[k] == 0 ? '.' : static_cast<char>('0' + grid[k]);
+            }
+            lengths[i] = outcomes[i] == BatchResult::UNSOLVABLE ? appendText(result, 81, " unsolvable") : 81;
+        }
+        propagated += batchStats.propagated;
+        searched += batchStats.searched;
+        unsolved += batchStats.unsolvable;
+    });
+    std::fflush(out);
+
+    printStats(options, puzzles, secondsSince(start),
+               ", " + std::to_string(propagated.load()) + " by propagation, " + std::to_string(searched.load()) +
+                   " by search, " + std::to_string(unsolved.load()) + " unsolvable");
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+    return puzzles < 0 ? 1 : 0;
+}
+
+int SudokuCli::runGenerate(const Options &options)
+{
+    // The bank first, so a failure leaves no empty -o file behind
+    SudokuPuzzleBankWriter bank;
+    if (!options.bank.empty() && !bank.open(options.bank))
+    {
+        std::cerr << "Cannot create puzzle bank: " << options.bank << "\n";
+        return 1;
+    }
+
+    std::FILE *out = openOutput(options);
+    if (out == nullptr)
+    {
+        return 1;
+    }
+    if (options.seed != 0)
+    {
+        SudokuGenerator::setSeed(options.seed);
+    }
+
+    GenerationStats stats;
+    char line[82];
+    line[81] = '\n';
+
+    auto start = std::chrono::steady_clock::now();
+    long long generated = 0;
+    bool missedBand = false;
+    for (; generated < options.count; generated++)
+    {
+        SudokuBoard puzzle;
+        if (!options.rated)
+        {
+            puzzle = SudokuGenerator::generatePuzzle(options.difficulty, options.symmetry);
+        }
+        else if (!SudokuGenerator::generateRatedPuzzle(options.difficulty, puzzle, &stats, options.symmetry))
+        {
+            std::cerr << "generate: no puzzle in the grader band after " << SudokuGenerator::RATED_ATTEMPTS
+                      << " attempts; try another --symmetry or drop --rated\n";
+            missedBand = true;
+            break;
+        }
+        puzzle.formatLine(line);
+        std::fwrite(line, 1, sizeof(line), out);
+
+        if (!options.bank.empty())
+        {
+            SudokuBoard solution = puzzle;
+            SudokuSolver::solve(solution);
+            bank.add(puzzle, solution, SudokuAdvancedChecks::ratePuzzle(puzzle).score, options.difficulty);
+        }
+    }
+    std::fflush(out);
+
+    bool ok = options.bank.empty() || bank.finish();
+    if (!ok)
+    {
+        std::cerr << "Failed to write puzzle bank: " << options.bank << "\n";
+    }
+
+    std::string extra;
+    if (options.rated)
+    {
+        extra = ", " + std::to_string(stats.attempts) + " attempts, " + std::to_string(stats.rejected) +
+                " rejected (" + std::to_string(stats.abandoned) + " part-way)";
+    }
+    printStats(options, generated, secondsSince(start), extra);
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+    return ok && !missedBand ? 0 : 1;
+}
+
+int SudokuCli::runRate(const Options &options)
+{
+    std::FILE *out = openOutput(options);
+    if (out == nullptr)
+    {
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    long long puzzles = streamPuzzles(options, out, [](SudokuBoard &board, const char *line, char *result)
+    {
+        PuzzleRating rating = SudokuAdvancedChecks::ratePuzzle(board);
+        std::memcpy(result, line, 81);
+        int length = 81;
+        length += std::snprintf(result + length, 64, " %d ", rating.score);
+        if (!rating.consistent)
+        {
+            return appendText(result, length, "invalid");
+        }
+        return appendText(result, length, SudokuAdvancedChecks::techniqueName(rating.hardest));
+    });
+    std::fflush(out);
+
+    printStats(options, puzzles, secondsSince(start), "");
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+    return puzzles < 0 ? 1 : 0;
+}
+
+int SudokuCli::runValidate(const Options &options)
+{
+    std::FILE *out = openOutput(options);
+    if (out == nullptr)
+    {
+        return 1;
+    }
+
+    // Completed grids take the batched mask check; the few that fail it are
+    // rescanned to tell a clash apart from blanks still to fill
+    std::atomic<long long> invalid(0);
+    auto start = std::chrono::steady_clock::now();
+    long long puzzles = streamBatches(options, out, [&](const uint8_t *cells, int count, char *results, int *lengths)
+    {
+        std::vector<int8_t> units(count);
+        SudokuValidator::validate(cells, count, units.data());
+
+        for (int i = 0; i < count; i++)
+        {
+            const uint8_t *grid = cells + i * 81;
+            char *result = results + i * SudokuPipeline::MAX_RESULT_LENGTH;
+            for (int k = 0; k < 81; k++)
+            {
+                result[k] = grid[k] == 0 ? '.' : static_cast<char>('0' + grid[k]);
+            }
+
+            if (units[i] == SudokuValidator::VALID)
+            {
+                lengths[i] = appendText(result, 81, " valid complete");
+                continue;
+            }
+            int conflict = SudokuValidator::firstConflictingUnit(grid);
+            if (conflict != SudokuValidator::VALID)
+            {
+                invalid++;
+                int length = appendText(result, 81, " invalid ");
+                lengths[i] = appendText(result, length, SudokuValidator::unitName(conflict).c_str());
+                continue;
+            }
+            lengths[i] = appendText(result, 81, " valid incomplete");
+        }
+    });
+    std::fflush(out);
+
+    printStats(options, puzzles, secondsSince(start), ", " + std::to_string(invalid.load()) + " invalid");
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+    return puzzles < 0 ? 1 : 0;
+}
+
+int SudokuCli::runCount(const Options &options)
+{
+    std::FILE *out = openOutput(options);
+    if (out == nullptr)
+    {
+        return 1;
+    }
+
+    int limit = options.limit;
+    auto start = std::chrono::steady_clock::now();
+    long long puzzles = streamPuzzles(options, out, [limit](SudokuBoard &board, const char *line, char *result)
+    {
+        std::memcpy(result, line, 81);
+        return 81 + std::snprintf(result + 81, 32, " %d", SudokuSolver::countSolutions(board, limit));
+    });
+    std::fflush(out);
+
+    printStats(options, puzzles, secondsSince(start), "");
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+    return puzzles < 0 ? 1 : 0;
+}
+
+int SudokuCli::runServe(const Options &options)
+{
+    if (!SudokuSocket::isSupported())
+    {
+        std::cerr << "serve needs Unix-domain sockets, which this build does not support\n";
+        return 1;
+    }
+
+    installStopHandlers();
+
+    SudokuPuzzleBank bank;
+    if (!options.bank.empty() && !bank.open(options.bank))
+    {
+        std::cerr << "Cannot open puzzle bank: " << options.bank << "\n";
+        return 1;
+    }
+
+    // NEW <difficulty> is served from this stock, refilled off the poll loop
+    SudokuPuzzleBuffer stock(options.buffer > 0 ? options.buffer : SERVE_STOCK, bank.isOpen() ? &bank : nullptr);
+
+    std::string socket = options.socket.empty() ? SERVE_SOCKET : options.socket;
+    SudokuSessionManager manager(static_cast<uint32_t>(options.sessions), &stock);
+    SessionServerStats stats;
+    if (!options.quiet)
+    {
+        std::cerr << "serve: listening on " << socket << "\n";
+    }
+    if (!SudokuSessionServer::run(socket, manager, stopRequested, stats))
+    {
+        std::cerr << "Cannot listen on " << socket << "\n";
+        return 1;
+    }
+
+    if (!options.quiet)
+    {
+        std::cerr << "serve: " << stats.connections << " connections, " << stats.commands << " commands, "
+                  << manager.sessionCount() << " sessions open (" << manager.memoryUsage() / 1024 << " KiB)\n";
+    }
+    return 0;
+}
+
+int SudokuCli::runService(const Options &options)
+{
+    if (!SudokuSocket::isSupported())
+    {
+        std::cerr << "service needs POSIX sockets, which this build does not support\n";
+        return 1;
+    }
+
+    installStopHandlers();
+
+    ServiceOptions serviceOptions;
+    serviceOptions.tcpPort = options.port;
+    serviceOptions.socketPath = options.socket.empty() && options.port == 0 ? SERVICE_SOCKET : options.socket;
+    serviceOptions.workers = options.threads;
+    serviceOptions.batchSize = options.batch;
+    serviceOptions.bufferSize = options.buffer;
+
+    SudokuPuzzleBank bank;
+    if (!options.bank.empty())
+    {
+        if (!bank.open(options.bank))
+        {
+            std::cerr << "Cannot open puzzle bank: " << options.bank << "\n";
+            return 1;
+        }
+        serviceOptions.bank = &bank;
+    }
+
+    if (!options.quiet)
+    {
+        std::cerr << "service: listening on";
+        if (!serviceOptions.socketPath.empty())
+        {
+            std::cerr << " " << serviceOptions.socketPath;
+        }
+        if (serviceOptions.tcpPort > 0)
+        {
+            std::cerr << " 127.0.0.1:" << serviceOptions.tcpPort;
+        }
+        std::cerr << "\n";
+    }
+
+    ServiceStats stats;
+    if (!SudokuService::run(serviceOptions, stopRequested, stats))
+    {
+        std::cerr << "Cannot listen for the service\n";
+        return 1;
+    }
+
+    if (!options.quiet)
+    {
+        double perBatch = stats.batches > 0 ? static_cast<double>(stats.requests) / stats.batches : 0.0;
+        std::cerr << "service: " << stats.connections << " connections, " << stats.requests << " requests in "
+                  << stats.batches << " batches (" << perBatch << " per batch), " << stats.bufferHits
+                  << " puzzles from the buffer\n";
+    }
+    return 0;
+}
+
+int SudokuCli::runLoadtest(const Options &options)
+{
+    if (!SudokuSocket::isSupported())
+    {
+        std::cerr << "loadtest needs POSIX sockets, which this build does not support\n";
+        return 1;
+    }
+#ifdef SIGPIPE
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+    // Request lines are built up front so the clients only time the round trip
+    std::vector<std::string> requests;
+    if (options.request == "generate")
+    {
+        const char *levels[] = {"easy", "medium", "hard"};
+        requests.push_back(std::string("GENERATE ") + levels[static_cast<int>(options.difficulty)] + "\n");
+    }
+    else
+    {
+        SudokuLineReader reader;
+        bool opened = options.input.empty() ? reader.open(stdin) : reader.open(options.input);
+        if (!opened)
+        {
+            std::cerr << "Cannot open input file: " << options.input << "\n";
+            return 1;
+        }
+        std::string prefix = options.request == "solve" ? "SOLVE " : "RATE ";
+        uint8_t cells[81];
+        while (reader.next(cells))
+        {
+            std::string line = prefix;
+            for (int i = 0; i < 81; i++)
+            {
+                line += cells[i] == 0 ? '.' : static_cast<char>('0' + cells[i]);
+            }
+            requests.push_back(line + "\n");
+        }
+        if (requests.empty())
+        {
+            std::cerr << "loadtest: no puzzles to send\n";
+            return 1;
+        }
+    }
+
+    int clients = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    if (clients < 1)
+    {
+        clients = 1;
+    }
+    std::string socket = options.socket.empty() ? SERVICE_SOCKET : options.socket;
+
+    // Closed loop: each client keeps exactly one request in flight
+    std::vector<SudokuHistogram> latencies(clients);
+    std::atomic<long long> errors(0);
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int client = 0; client < clients; client++)
+    {
+        threads.emplace_back([&, client]
+        {
+            int connection = options.port > 0 ? SudokuSocket::connectTcp("127.0.0.1", options.port)
+                                              : SudokuSocket::connectUnix(socket);
+            if (connection < 0)
+            {
+                failed = true;
+                return;
+            }
+
+            std::string pending;
+            char buffer[4096];
+            for (long long i = client; i < options.count; i += clients)
+            {
+                const std::string &request = requests[i % requests.size()];
+                auto sent = std::chrono::steady_clock::now();
+                if (!SudokuSocket::sendAll(connection, request.data(), request.size()))
+                {
+                    failed = true;
+                    break;
+                }
+
+                size_t newline;
+                while ((newline = pending.find('\n')) == std::string::npos)
+                {
+                    bool wouldBlock;
+                    long bytes = SudokuSocket::receive(connection, buffer, sizeof(buffer), wouldBlock);
+                    if (bytes <= 0)
+                    {
+                        failed = true;
+                        SudokuSocket::close(connection);
+                        return;
+                    }
+                    pending.append(buffer, static_cast<size_t>(bytes));
+                }
+                auto elapsed = std::chrono::steady_clock::now() - sent;
+                latencies[client].record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+
+                if (pending.compare(0, 3, "ERR") == 0)
+                {
+                    errors++;
+                }
+                pending.erase(0, newline + 1);
+            }
+            SudokuSocket::close(connection);
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    double seconds = secondsSince(start);
+
+    SudokuHistogram total;
+    for (const SudokuHistogram &latency : latencies)
+    {
+        total.merge(latency);
+    }
+    if (failed)
+    {
+        std::cerr << "loadtest: lost the connection to the service\n";
+    }
+    std::cerr << "loadtest: " << total.count() << " " << options.request << " requests from " << clients
+              << " clients in " << seconds << " s (" << static_cast<long long>(total.count() / seconds)
+              << " req/s), " << errors.load() << " errors\n"
+              << "latency: " << total.summary() << "\n";
+    return failed ? 1 : 0;
+}
+
+template <typename Geometry>
+int SudokuCli::runGrid(const Options &options)
+{
+    using Grid = SudokuGrid<Geometry>;
+    const int cells = Geometry::CELLS;
+
+    std::FILE *out = openOutput(options);
+    if (out == nullptr)
+    {
+        return 1;
+    }
+    std::vector<char> line(cells + 32);
+    auto start = std::chrono::steady_clock::now();
+
+    if (options.command == "generate")
+    {
+        std::mt19937 random(options.seed != 0 ? options.seed : std::random_device()());
+        for (long long i = 0; i < options.count; i++)
+        {
+            Grid puzzle = SudokuGridGenerator<Geometry>::generatePuzzle(options.difficulty, random);
+            puzzle.format(line.data());
+            line[cells] = '\n';
+            std::fwrite(line.data(), 1, cells + 1, out);
+        }
+        std::fflush(out);
+        printStats(options, options.count, secondsSince(start), "");
+        if (out != stdout)
+        {
+            std::fclose(out);
+        }
+        return 0;
+    }
+
+    std::ifstream file;
+    if (!options.input.empty())
+    {
+        file.open(options.input);
+        if (!file)
+        {
+            std::cerr << "Cannot open input file: " << options.input << "\n";
+            return 1;
+        }
+    }
+    std::istream &in = options.input.empty() ? std::cin : file;
+
+    long long puzzles = 0;
+    long long invalid = 0;
+    long long flagged = 0; // Unsolvable (solve) or invalid (validate)
+    std::string text;
+    while (std::getline(in, text))
+    {
+        if (!text.empty() && text.back() == '\r')
+        {
+            text.pop_back();
+        }
+        Grid grid;
+        if (!grid.parse(text.data(), text.size()))
+        {
+            invalid += !text.empty();
+            continue;
+        }
+
+        int length = cells;
+        if (options.command == "validate")
+        {
+            grid.format(line.data());
+            std::string conflict = SudokuGridValidator<Geometry>::conflict(grid);
+            if (!conflict.empty())
+            {
+                length = appendText(line.data(), cells, (" invalid " + conflict).c_str());
+                flagged++;
+            }
+            else
+            {
+                length = appendText(line.data(), cells, grid.isFull() ? " valid complete" : " valid incomplete");
+            }
+        }
+        else if (options.command == "rate")
+        {
+            PuzzleRating rating = SudokuGridTechniques<Geometry>::rate(grid);
+            grid.format(line.data());
+            length += std::snprintf(line.data() + cells, 32, " %d ", rating.score);
+            length = appendText(line.data(), length,
+                                rating.consistent ? SudokuAdvancedChecks::techniqueName(rating.hardest) : "invalid");
+        }
+        else if (options.command == "solve")
+        {
+            bool solved = SudokuGridSolver<Geometry>::solve(grid);
+            grid.format(line.data());
+            if (!solved)
+            {
+                length = appendText(line.data(), cells, " unsolvable");
+                flagged++;
+            }
+        }
+        else
+        {
+            grid.format(line.data());
+            length += std::snprintf(line.data() + cells, 32, " %d",
+                                    SudokuGridSolver<Geometry>::countSolutions(grid, options.limit));
+        }
+        line[length++] = '\n';
+        std::fwrite(line.data(), 1, length, out);
+        puzzles++;
+    }
+    std::fflush(out);
+
+    if (invalid > 0 && !options.quiet)
+    {
+        std::cerr << "Skipped " << invalid << " malformed line(s)\n";
+    }
+    std::string extra;
+    if (options.command == "solve")
+        extra = ", " + std::to_string(flagged) + " unsolvable";
+    else if (options.command == "validate")
+        extra = ", " + std::to_string(flagged) + " invalid";
+    printStats(options, puzzles, secondsSince(start), extra);
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+    return 0;
+}
+
+int SudokuCli::runKiller(const Options &options)
+{
+    std::FILE *out = openOutput(options);
+    if (out == nullptr)
+    {
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    if (options.command == "generate")
+    {
+        std::mt19937 random(options.seed != 0 ? options.seed : std::random_device()());
+        for (long long i = 0; i < options.count; i++)
+        {
+            std::string text = SudokuKillerGenerator::generatePuzzle(options.difficulty, random).format() + "\n";
+            std::fwrite(text.data(), 1, text.size(), out);
+        }
+        std::fflush(out);
+        printStats(options, options.count, secondsSince(start), "");
+        if (out != stdout)
+        {
+            std::fclose(out);
+        }
+        return 0;
+    }
+
+    std::ifstream file;
+    if (!options.input.empty())
+    {
+        file.open(options.input);
+        if (!file)
+        {
+            std::cerr << "Cannot open input file: " << options.input << "\n";
+            return 1;
+        }
+    }
+    std::istream &in = options.input.empty() ? std::cin : file;
+
+    long long puzzles = 0;
+    long long invalid = 0;
+    long long flagged = 0; // Unsolvable (solve) or invalid (validate)
+    std::string text;
+    char line[81];
+    while (std::getline(in, text))
+    {
+        if (!text.empty() && text.back() == '\r')
+        {
+            text.pop_back();
+        }
+        SudokuKiller puzzle;
+        if (!puzzle.parse(text))
+        {
+            invalid += !text.empty();
+            continue;
+        }
+
+        // Solved grids keep their cages, so solve output can be piped into validate
+        std::string result;
+        if (options.command == "solve")
+        {
+            SudokuBoard solution;
+            if (SudokuKillerSolver::solve(puzzle, solution) == SolveResult::SOLVED)
+            {
+                puzzle.getGivens() = solution;
+                result = puzzle.format();
+            }
+            else
+            {
+                result = puzzle.format() + " unsolvable";
+                flagged++;
+            }
+        }
+        else if (options.command == "validate")
+        {
+            const SudokuBoard &grid = puzzle.getGivens();
+            uint8_t cells[81];
+            for (int cell = 0; cell < 81; cell++)
+            {
+                cells[cell] = static_cast<uint8_t>(grid.getValue(cell / 9, cell % 9));
+            }
+            grid.formatLine(line);
+            result.assign(line, 81);
+            int unit = SudokuValidator::firstConflictingUnit(cells);
+            int cage = puzzle.firstBrokenCage(grid);
+            if (unit != SudokuValidator::VALID)
+                result += " invalid " + SudokuValidator::unitName(unit);
+            else if (cage != SudokuKiller::NO_CAGE)
+                result += " invalid cage " + std::to_string(cage + 1);
+            else
+                result += grid.isFull() ? " valid complete" : " valid incomplete";
+            flagged += unit != SudokuValidator::VALID || cage != SudokuKiller::NO_CAGE;
+        }
+        else
+        {
+            puzzle.getGivens().formatLine(line);
+            result.assign(line, 81);
+            result += " " + std::to_string(SudokuKillerSolver::countSolutions(puzzle, options.limit));
+        }
+        result += '\n';
+        std::fwrite(result.data(), 1, result.size(), out);
+        puzzles++;
+    }
+    std::fflush(out);
+
+    if (invalid > 0 && !options.quiet)
+    {
+        std::cerr << "Skipped " << invalid << " malformed line(s)\n";
+    }
+    std::string extra;
+    if (options.command == "solve")
+        extra = ", " + std::to_string(flagged) + " unsolvable";
+    else if (options.command == "validate")
+        extra = ", " + std::to_string(flagged) + " invalid";
+    printStats(options, puzzles, secondsSince(start), extra);
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+    return 0;
+}
+
+int SudokuCli::runSized(const Options &options)
+{
+    if (options.command != "solve" && options.command != "generate" && options.command != "validate" &&
+        options.command != "count" && options.command != "rate")
+    {
+        std::cerr << options.command << " only handles classic 9x9 grids\n";
+        return 2;
+    }
+    if (options.rated || options.symmetry != Symmetry::NONE || !options.bank.empty())
+    {
+        std::cerr << "--rated, --symmetry and --bank only handle classic 9x9 grids\n";
+        return 2;
+    }
+    if (options.command == "rate" && options.variant == "killer")
+    {
+        std::cerr << "rate does not handle killer cages\n";
+        return 2;
+    }
+
+    if (!options.variant.empty())
+    {
+        if (options.boxRows != 3 || options.boxCols != 3)
+        {
+            std::cerr << "Variants are 9x9 only\n";
+            return 2;
+        }
+        if (options.variant == "killer")
+            return runKiller(options);
+        if (options.variant == "jigsaw")
+        {
+            std::string error;
+            if (options.layout.empty() || !SudokuJigsaw::loadLayout(options.layout, error))
+            {
+                std::cerr << "Jigsaw layout: " << (options.layout.empty() ? "--layout FILE is required" : error)
+                          << "\n";
+                return 2;
+            }
+            return runGrid<JigsawGeometry>(options);
+        }
+        if (options.variant == "samurai")
+            return runGrid<SamuraiGeometry>(options);
+        if (options.variant == "x")
+            return runGrid<GeometryX>(options);
+        if (options.variant == "windoku")
+            return runGrid<GeometryWindoku>(options);
+        if (options.variant == "antiknight")
+            return runGrid<GeometryAntiKnight>(options);
+        return runGrid<GeometryAntiKing>(options);
+    }
+
+    int shape = options.boxRows * 10 + options.boxCols;
+    switch (shape)
+    {
+    case 22:
+        return runGrid<Geometry4>(options);
+    case 23:
+        return runGrid<Geometry6>(options);
+    case 34:
+        return runGrid<Geometry12>(options);
+    case 44:
+        return runGrid<Geometry16>(options);
+    case 55:
+        return runGrid<Geometry25>(options);
+    default:
+        std::cerr << "Unsupported box shape: " << options.boxRows << "x" << options.boxCols << "\n";
+        return 2;
+    }
+}
+
+int SudokuCli::run(int argc, char *argv[])
+{
+    Options options;
+    if (argc < 2 || !isCommand(argv[1]) || !parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return 2;
+    }
+
+    if (options.boxRows != 3 || options.boxCols != 3 || !options.variant.empty())
+        return runSized(options);
+    if (options.command == "solve")
+        return runSolve(options);
+    if (options.command == "generate")
+        return runGenerate(options);
+    if (options.command == "rate")
+        return runRate(options);
+    if (options.command == "validate")
+        return runValidate(options);
+    if (options.command == "serve")
+        return runServe(options);
+    if (options.command == "service")
+        return runService(options);
+    if (options.command == "loadtest")
+        return runLoadtest(options);
+    return runCount(options);
+}
@@ -12,9 +12,15 @@
 #include "SudokuAdvancedChecks.hpp"
 #endif
 
-SudokuGame::SudokuGame() : gameRunning(true)
+const char *const SudokuGame::JOURNAL_FILE = "sudoku.journal";
+
+SudokuGame::SudokuGame() : gameRunning(true), renderer(SudokuRenderer::detectMode())
 {
-    initializeDefaultPuzzle();
+    if (!resumeFromJournal())
+    {
+        initializeDefaultPuzzle();
+        startPuzzle();
+    }
 }
 
 void SudokuGame::run()
@@ -23,7 +29,7 @@ void SudokuGame::run()
 
     while (gameRunning)
     {
-        board.printBoard();
+        renderer.render(board);
         displayMenu();
 
         int choice = getMenuChoice();
@@ -42,26 +48,28 @@ void SudokuGame::run()
         case 4:
             savePuzzleToFile();
             break;
-#ifdef BUILD_GENERATOR
         case 5:
+            giveHint();
+            break;
+        case 6:
+            undoMove();
+            break;
+        case 7:
+            redoMove();
+            break;
+#ifdef BUILD_GENERATOR
+        case 8:
             generateNewPuzzle();
             break;
 #endif
 #ifdef BUILD_ADVANCED
-        case 6:
+        case 9:
             solveWithAdvancedTechniques();
             break;
 #endif
         default:
             // Handle exit option dynamically
-            int exitOption = 5;
-#ifdef BUILD_GENERATOR
-            exitOption = 6;
-#endif
-#ifdef BUILD_ADVANCED
-            exitOption = 7;
-#endif
-            if (choice == exitOption)
+            if (choice == exitOption())
             {
                 quit();
             }
@@ -80,26 +88,33 @@ void SudokuGame::displayMenu()
     std::cout << "2) Solve automatically\n";
     std::cout << "3) Load puzzle from file\n";
     std::cout << "4) Save current puzzle to file\n";
+    std::cout << "5) Get a hint\n";
+    std::cout << "6) Undo (" << history.undoDepth() << ")\n";
+    std::cout << "7) Redo (" << history.redoDepth() << ")\n";
 
 #ifdef BUILD_GENERATOR
-    std::cout << "5) Generate new puzzle\n";
+    std::cout << "8) Generate new puzzle\n";
 #endif
 
 #ifdef BUILD_ADVANCED
-    std::cout << "6) Solve with advanced techniques\n";
+    std::cout << "9) Solve with advanced techniques\n";
 #endif
 
+    std::cout << exitOption() << ") Exit\n";
+    std::cout << "Choice: ";
+}
+
+int SudokuGame::exitOption() const
+{
     // Exit option adjusts based on optional features
-    int exitOption = 5;
+    int option = 8;
 #ifdef BUILD_GENERATOR
-    exitOption = 6;
+    option = 9;
 #endif
 #ifdef BUILD_ADVANCED
-    exitOption = 7;
+    option = 10;
 #endif
-
-    std::cout << exitOption << ") Exit\n";
-    std::cout << "Choice: ";
+    return option;
 }
 
 int SudokuGame::getMenuChoice()
@@ -150,41 +165,260 @@ void SudokuGame::enterMove()
     col--;
 
     // Check if cell is already filled or move is invalid
-    if (!board.isEmpty(row, col) || !board.isValidMove(row, col, value))
+    if (!board.isEmpty(row, col) || !(masks.candidates(row * 9 + col) & (1u << (value - 1))))
     {
         std::cout << "Invalid move. That cell might be occupied or the placement breaks Sudoku rules.\n\n";
         return;
     }
 
-    // Attempt to set the value
-    if (board.setValue(row, col, value))
+    applyMove(row, col, value);
+    std::cout << "Move accepted!\n";
+
+    // Legal is not the same as right; the cached solution knows the difference
+    if (solver.isUnique() && solver.value(row, col) != value)
+    {
+        std::cout << "Careful: that digit does not lead to the solution.\n";
+    }
+    std::cout << "\n";
+
+    // Check if puzzle is solved
+    if (board.isFull())
+    {
+        std::cout << "Great job! The Sudoku is solved!\n\n";
+    }
+}
+
+void SudokuGame::applyMove(int row, int col, int value, bool chained)
+{
+    int cell = row * 9 + col;
+    Move move{static_cast<uint8_t>(cell), static_cast<uint8_t>(board.getValue(row, col)),
+              static_cast<uint8_t>(value), chained};
+
+    if (move.oldValue != 0)
+    {
+        masks.remove(cell, move.oldValue);
+    }
+    if (value != 0)
+    {
+        masks.place(cell, value);
+    }
+    board.getBoard()[row][col] = value;
+    history.record(move);
+
+    if (journal.isOpen() && !journal.appendMove(move))
+    {
+        std::cout << "Warning: autosave failed; this session will not survive a restart.\n";
+    }
+}
+
+void SudokuGame::stepMove(const Move &move, bool forward)
+{
+    // Only the two digits involved change, so the masks follow in O(1)
+    int from = forward ? move.oldValue : move.newValue;
+    int to = forward ? move.newValue : move.oldValue;
+    if (from != 0)
+    {
+        masks.remove(move.cell, from);
+    }
+    if (to != 0)
+    {
+        masks.place(move.cell, to);
+    }
+    board.getBoard()[move.cell / 9][move.cell % 9] = to;
+    if (journal.isOpen())
+    {
+        if (forward)
+            journal.appendRedo();
+        else
+            journal.appendUndo();
+    }
+}
+
+void SudokuGame::undoMove()
+{
+    Move move;
+    if (!history.undo(move))
+    {
+        std::cout << "Nothing to undo.\n\n";
+        return;
+    }
+
+    // A chained move takes the one before it along, back to the start of its batch
+    int undone = 1;
+    stepMove(move, false);
+    while (move.chained && history.undo(move))
+    {
+        stepMove(move, false);
+        undone++;
+    }
+
+    if (undone == 1)
+        std::cout << "Undid move at row " << move.cell / 9 + 1 << ", column " << move.cell % 9 + 1 << ".\n\n";
+    else
+        std::cout << "Undid " << undone << " moves.\n\n";
+}
+
+void SudokuGame::redoMove()
+{
+    Move move;
+    if (!history.redo(move))
+    {
+        std::cout << "Nothing to redo.\n\n";
+        return;
+    }
+
+    int redone = 1;
+    stepMove(move, true);
+    while (history.redoChained() && history.redo(move))
     {
-        std::cout << "Move accepted!\n\n";
+        stepMove(move, true);
+        redone++;
+    }
 
-        // Check if puzzle is solved
-        if (board.isFull())
+    if (redone == 1)
+        std::cout << "Redid move at row " << move.cell / 9 + 1 << ", column " << move.cell % 9 + 1 << ".\n\n";
+    else
+        std::cout << "Redid " << redone << " moves.\n\n";
+}
+
+void SudokuGame::startPuzzle()
+{
+    history.clear();
+    masks.clear();
+    for (int cell = 0; cell < 81; cell++)
+    {
+        int value = board.getValue(cell / 9, cell % 9);
+        if (value >= 1 && value <= 9)
         {
-            std::cout << "Great job! The Sudoku is solved!\n\n";
+            masks.place(cell, value);
         }
     }
-    else
+    solver.start(board);
+
+    if (!journal.begin(JOURNAL_FILE, board))
     {
-        std::cout << "Invalid move. That cell might be occupied or the placement breaks Sudoku rules.\n\n";
+        std::cout << "Warning: cannot write " << JOURNAL_FILE << "; autosave is off.\n";
+    }
+}
+
+bool SudokuGame::resumeFromJournal()
+{
+    SudokuBoard puzzle;
+    long validLength = 0;
+    if (!SudokuJournal::replay(JOURNAL_FILE, puzzle, board, history, validLength))
+    {
+        return false;
     }
+
+    // The solver works from the givens so earlier mistakes do not hide the solution
+    solver.start(puzzle);
+    masks.clear();
+    for (int cell = 0; cell < 81; cell++)
+    {
+        int value = board.getValue(cell / 9, cell % 9);
+        if (value >= 1 && value <= 9)
+        {
+            masks.place(cell, value);
+        }
+    }
+    journal.resume(JOURNAL_FILE, validLength);
+
+    std::cout << "Resumed the previous session from " << JOURNAL_FILE << " (" << history.undoDepth()
+              << " move(s) to undo).\n\n";
+    return true;
 }
 
 void SudokuGame::solveAutomatically()
 {
-    std::cout << "Solving puzzle...\n";
+    switch (solver.status())
+    {
+    case SolutionStatus::READY:
+    {
+        // Fill in the solution as one batch of moves, so a single undo takes it
+        // back; entries that disagree with the solution are corrected along the way
+        int changed = 0;
+        int corrected = 0;
+        for (int row = 0; row < 9; row++)
+        {
+            for (int col = 0; col < 9; col++)
+            {
+                int value = solver.value(row, col);
+                if (board.getValue(row, col) == value)
+                {
+                    continue;
+                }
+                corrected += board.isEmpty(row, col) ? 0 : 1;
+                applyMove(row, col, value, changed > 0);
+                changed++;
+            }
+        }
+        std::cout << "Puzzle solved!" << (changed > 0 ? " (Undo takes it back.)" : "") << "\n";
+        if (corrected > 0)
+        {
+            std::cout << "Corrected " << corrected << " wrong entr" << (corrected == 1 ? "y" : "ies") << ".\n";
+        }
+        std::cout << "\n";
+        break;
+    }
+    case SolutionStatus::UNSOLVABLE:
+        std::cout << "No solution found: " << SudokuSolver::describe(board, solver.contradiction()) << "\n\n";
+        break;
+    case SolutionStatus::PENDING:
+        std::cout << "Still solving in the background; try again in a moment.\n\n";
+        break;
+    case SolutionStatus::NONE:
+        solver.start(board);
+        std::cout << "Started solving in the background; try again in a moment.\n\n";
+        break;
+    }
+}
 
-    if (SudokuSolver::solve(board))
+void SudokuGame::giveHint()
+{
+    if (solver.status() == SolutionStatus::UNSOLVABLE)
     {
-        std::cout << "Puzzle solved!\n\n";
+        std::cout << "No hint available: " << SudokuSolver::describe(board, solver.contradiction()) << "\n\n";
+        return;
     }
-    else
+    if (solver.status() != SolutionStatus::READY)
     {
-        std::cout << "No solution found. The puzzle may be unsolvable.\n\n";
+        std::cout << "Still solving in the background; try again in a moment.\n\n";
+        return;
     }
+
+    // A wrong entry matters more than the next empty cell
+    int emptyRow = -1;
+    int emptyCol = -1;
+    for (int row = 0; row < 9; row++)
+    {
+        for (int col = 0; col < 9; col++)
+        {
+            if (board.isEmpty(row, col))
+            {
+                if (emptyRow < 0)
+                {
+                    emptyRow = row;
+                    emptyCol = col;
+                }
+            }
+            else if (board.getValue(row, col) != solver.value(row, col))
+            {
+                std::cout << "Hint: the " << board.getValue(row, col) << " at row " << row + 1 << ", column "
+                          << col + 1 << " is wrong.\n\n";
+                return;
+            }
+        }
+    }
+
+    if (emptyRow < 0)
+    {
+        std::cout << "The puzzle is already solved.\n\n";
+        return;
+    }
+
+    int value = solver.value(emptyRow, emptyCol);
+    applyMove(emptyRow, emptyCol, value);
+    std::cout << "Hint: row " << emptyRow + 1 << ", column " << emptyCol + 1 << " is " << value << ".\n\n";
 }
 
 void SudokuGame::loadPuzzleFromFile()
@@ -201,6 +435,9 @@ void SudokuGame::loadPuzzleFromFile()
     {
         std::cout << "Failed to load puzzle from file. Check filename and format.\n\n";
     }
+
+    // A failed load can leave a partly overwritten board, so start over from whatever is there
+    startPuzzle();
 }
 
 void SudokuGame::savePuzzleToFile()
@@ -300,6 +537,7 @@ void SudokuGame::generateNewPuzzle()
 
     std::cout << "Generating new puzzle...\n";
     board = SudokuGenerator::generatePuzzle(difficulty);
+    startPuzzle();
     std::cout << "New puzzle generated!\n\n";
 }
 #endif
@@ -309,7 +547,9 @@ void SudokuGame::solveWithAdvancedTechniques()
 {
     std::cout << "Solving with advanced techniques...\n";
 
-    if (SudokuAdvancedChecks::solveWithAdvancedTechniques(board))
+    bool solved = SudokuAdvancedChecks::solveWithAdvancedTechniques(board);
+    startPuzzle();
+    if (solved)
     {
         std::cout << "Puzzle solved using advanced techniques!\n\n";
     }
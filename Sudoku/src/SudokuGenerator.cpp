@@ -1,16 +1,193 @@
 #include "SudokuGenerator.hpp"
 #include "SudokuSolver.hpp"
+#include "SudokuAdvancedChecks.hpp"
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <fstream>
+#include <iterator>
+#include <mutex>
 #include <random>
+#include <thread>
 #include <vector>
 
+namespace
+{
+    // Under GridSource::TRANSFORM the low-clue search still searches for every
+    // this-many-th grid: transforms only reach the seed grids' classes, and
+    // whether a grid holds any 17-20 clue puzzle depends on its class
+    const int LOW_CLUE_FRESH_GRIDS = 4;
+
+    // Built-in seed grids; every symmetry transform of these is a valid grid
+    const char *const BUILTIN_SEED_GRIDS[] = {
+        "251436879687192345943578621135749286764825913829361457378914562592687134416253798",
+        "419253687625178493837649125548712936261935874793486512974361258352894761186527349",
+        "952314678431786259768259143146592837273648915589137462615923784827465391394871526",
+        "968123457751649382432587196123458679596712834874396521217834965685971243349265718",
+        "165324789397158246428967351213795864574683912689241573952816437746539128831472695",
+        "435216789127398564986547312258164937749835621361729845574682193612953478893471256",
+        "192374658843526917567198342216749835459863271378251496735982164924615783681437529",
+        "452139768681274395739685241294316857168957423375428916526843179817592634943761582",
+    };
+
+    // Take the next permutation of 0..n-1 out of a mixed-radix random code
+    void takePermutation(uint64_t &code, int n, uint8_t *perm)
+    {
+        uint8_t remaining[9];
+        for (int i = 0; i < n; i++)
+        {
+            remaining[i] = static_cast<uint8_t>(i);
+        }
+
+        for (int left = n; left > 0; left--)
+        {
+            int pick = static_cast<int>(code % left);
+            code /= left;
+            perm[n - left] = remaining[pick];
+            remaining[pick] = remaining[left - 1];
+        }
+    }
+
+    // Cells that must be given or blank together under a layout symmetry
+    struct Orbit
+    {
+        int cells[4];
+        int size;
+    };
+
+    // Partition the 81 cells into orbits; returns the number of orbits
+    int buildOrbits(Symmetry symmetry, Orbit *orbits)
+    {
+        bool seen[81] = {false};
+        int count = 0;
+
+        for (int cell = 0; cell < 81; cell++)
+        {
+            if (seen[cell])
+            {
+                continue;
+            }
+
+            Orbit &orbit = orbits[count++];
+            orbit.size = 0;
+
+            int row = cell / 9;
+            int col = cell % 9;
+            int images[4] = {cell, cell, cell, cell};
+            switch (symmetry)
+            {
+            case Symmetry::ROTATIONAL_180:
+                images[1] = (8 - row) * 9 + (8 - col);
+                break;
+            case Symmetry::ROTATIONAL_90:
+                images[1] = col * 9 + (8 - row);
+                images[2] = (8 - row) * 9 + (8 - col);
+                images[3] = (8 - col) * 9 + row;
+                break;
+            case Symmetry::DIAGONAL:
+                images[1] = col * 9 + row;
+                break;
+            case Symmetry::MIRROR:
+                images[1] = row * 9 + (8 - col);
+                break;
+            default:
+                break;
+            }
+
+            for (int image : images)
+            {
+                if (!seen[image])
+                {
+                    seen[image] = true;
+                    orbit.cells[orbit.size++] = image;
+                }
+            }
+        }
+        return count;
+    }
+
+    // Blank an orbit, remembering its values
+    void clearOrbit(std::vector<std::vector<int>> &cells, const Orbit &orbit, int *backup)
+    {
+        for (int i = 0; i < orbit.size; i++)
+        {
+            backup[i] = cells[orbit.cells[i] / 9][orbit.cells[i] % 9];
+            cells[orbit.cells[i] / 9][orbit.cells[i] % 9] = 0;
+        }
+    }
+
+    void restoreOrbit(std::vector<std::vector<int>> &cells, const Orbit &orbit, const int *backup)
+    {
+        for (int i = 0; i < orbit.size; i++)
+        {
+            cells[orbit.cells[i] / 9][orbit.cells[i] % 9] = backup[i];
+        }
+    }
+
+    // Uniqueness after blanking an orbit of a uniquely solvable puzzle: a single
+    // cell only needs a search that avoids the removed value, larger orbits count
+    // solutions once for the whole orbit
+    bool stillUnique(const SudokuBoard &puzzle, const Orbit &orbit, const int *backup)
+    {
+        if (orbit.size == 1)
+        {
+            return !SudokuSolver::hasSolutionWithout(puzzle, orbit.cells[0] / 9, orbit.cells[0] % 9, backup[0]);
+        }
+        return SudokuSolver::countSolutions(puzzle, 2) == 1;
+    }
+
+    // Orbits dug between checks that a rated attempt can still reach its band
+    const int PROBE_INTERVAL = 8;
+
+    // True if puzzle cannot reach the band however many of the untried orbits are
+    // dug out: with all of them blanked it still solves by techniques below the band,
+    // and blanking clues never makes a puzzle easier. probe is scratch space.
+    bool belowBand(const SudokuBoard &puzzle, SudokuBoard &probe, const Orbit *untried, int count,
+                   const RatingBand &band)
+    {
+        probe = puzzle;
+        int backup[4];
+        for (int i = 0; i < count; i++)
+        {
+            clearOrbit(probe.getBoard(), untried[i], backup);
+        }
+        PuzzleRating rating = SudokuAdvancedChecks::ratePuzzle(probe, band.minScore - 1);
+        return rating.solved && rating.score < band.minScore;
+    }
+
+    // Map each of the 9 rows (or columns) to a source line: permute the three
+    // bands (stacks), then the three lines inside each band
+    void takeLineMap(uint64_t &code, uint8_t *lineMap)
+    {
+        uint8_t bands[3];
+        takePermutation(code, 3, bands);
+
+        for (int band = 0; band < 3; band++)
+        {
+            uint8_t lines[3];
+            takePermutation(code, 3, lines);
+            for (int i = 0; i < 3; i++)
+            {
+                lineMap[band * 3 + i] = static_cast<uint8_t>(bands[band] * 3 + lines[i]);
+            }
+        }
+    }
+}
+
 std::mt19937 SudokuGenerator::rng(std::chrono::steady_clock::now().time_since_epoch().count());
+GridSource SudokuGenerator::gridSource = GridSource::TRANSFORM;
+std::vector<SudokuGenerator::Grid> SudokuGenerator::seedGrids = builtinSeedGrids();
+
+SudokuBoard SudokuGenerator::generatePuzzle(Difficulty difficulty, Symmetry symmetry)
+{
+    return generatePuzzle(difficulty, rng, symmetry);
+}
 
-SudokuBoard SudokuGenerator::generatePuzzle(Difficulty difficulty)
+SudokuBoard SudokuGenerator::generatePuzzle(Difficulty difficulty, std::mt19937 &random, Symmetry symmetry)
 {
     // First generate a complete board
-    SudokuBoard board = generateComplete();
+    SudokuBoard board;
+    generateComplete(board, random);
 
     // Determine how many cells to remove based on difficulty
     int cellsToRemove;
@@ -31,35 +208,456 @@ SudokuBoard SudokuGenerator::generatePuzzle(Difficulty difficulty)
     }
 
     // Remove cells while ensuring unique solution
-    removeCells(board, cellsToRemove);
+    removeCells(board, cellsToRemove, symmetry, random);
 
     return board;
 }
 
+RatingBand SudokuGenerator::ratingBand(Difficulty difficulty)
+{
+    switch (difficulty)
+    {
+    case Difficulty::EASY:
+        return {0, 15}; // Hidden singles only
+    case Difficulty::MEDIUM:
+        return {23, 30}; // Naked singles up to naked pairs
+    case Difficulty::HARD:
+        return {32, 70}; // X-wings, hidden pairs, triples or search
+    default:
+        return {23, 30};
+    }
+}
+
+bool SudokuGenerator::generateRatedPuzzle(Difficulty difficulty, SudokuBoard &puzzle, GenerationStats *stats,
+                                          Symmetry symmetry)
+{
+    return generateRatedPuzzle(ratingBand(difficulty), puzzle, stats, RATED_ATTEMPTS, symmetry);
+}
+
+bool SudokuGenerator::generateRatedPuzzle(const RatingBand &band, SudokuBoard &puzzle,
+                                          GenerationStats *stats, int maxAttempts, Symmetry symmetry)
+{
+    GenerationStats local;
+    GenerationStats &counters = stats ? *stats : local;
+
+    Orbit orbits[81];
+    int orbitCount = buildOrbits(symmetry, orbits);
+
+    auto &cells = puzzle.getBoard();
+    SudokuBoard probe;
+    for (int attempt = 0; attempt < maxAttempts; attempt++)
+    {
+        counters.attempts++;
+        generateComplete(puzzle);
+        std::shuffle(orbits, orbits + orbitCount, rng);
+
+        int score = 0;
+        bool outOfReach = false;
+        for (int i = 0; i < orbitCount && !outOfReach; i++)
+        {
+            int backup[4];
+            clearOrbit(cells, orbits[i], backup);
+
+            // The grader stops as soon as the puzzle gets harder than the band, so
+            // overshooting removals are rejected without running a full rating
+            counters.ratings++;
+            PuzzleRating rating = SudokuAdvancedChecks::ratePuzzle(puzzle, band.maxScore);
+
+            bool keep;
+            if (rating.score > band.maxScore)
+            {
+                keep = false;
+            }
+            else if (rating.solved)
+            {
+                keep = true; // Solved by sound deductions, so the solution is unique
+            }
+            else
+            {
+                counters.uniquenessChecks++;
+                keep = stillUnique(puzzle, orbits[i], backup);
+            }
+
+            if (keep)
+            {
+                score = rating.score;
+            }
+            else
+            {
+                restoreOrbit(cells, orbits[i], backup);
+            }
+
+            if (score < band.minScore && i % PROBE_INTERVAL == PROBE_INTERVAL - 1 && i + 1 < orbitCount)
+            {
+                counters.ratings++;
+                outOfReach = belowBand(puzzle, probe, orbits + i + 1, orbitCount - i - 1, band);
+            }
+        }
+
+        if (!outOfReach && score >= band.minScore)
+        {
+            return true;
+        }
+        counters.rejected++;
+        counters.abandoned += outOfReach ? 1 : 0;
+    }
+
+    return false;
+}
+
+SudokuBoard SudokuGenerator::generateMinimal()
+{
+    SudokuBoard puzzle;
+    generateComplete(puzzle);
+    reduceToMinimal(puzzle, rng);
+    return puzzle;
+}
+
+int SudokuGenerator::reduceToMinimal(SudokuBoard &puzzle, std::mt19937 &random)
+{
+    auto &cells = puzzle.getBoard();
+
+    int positions[81];
+    int clues = 0;
+    for (int i = 0; i < 81; i++)
+    {
+        if (cells[i / 9][i % 9] != 0)
+        {
+            positions[clues++] = i;
+        }
+    }
+    std::shuffle(positions, positions + clues, random);
+
+    // One pass suffices: removing clues never makes an earlier clue removable again
+    int kept = clues;
+    for (int i = 0; i < clues; i++)
+    {
+        int row = positions[i] / 9;
+        int col = positions[i] % 9;
+        int backup = cells[row][col];
+
+        cells[row][col] = 0;
+        if (SudokuSolver::hasSolutionWithout(puzzle, row, col, backup))
+        {
+            cells[row][col] = backup;
+        }
+        else
+        {
+            kept--;
+        }
+    }
+    return kept;
+}
+
+MinimalSearchResult SudokuGenerator::searchLowClue(const MinimalSearchOptions &options)
+{
+    using Clock = std::chrono::steady_clock;
+
+    MinimalSearchResult result;
+    std::mutex resultMutex;
+    std::atomic<int> found(0);
+
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+                                std::chrono::duration<double>(options.timeBudgetSeconds));
+
+    int threadCount = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    if (threadCount <= 0)
+    {
+        threadCount = 1;
+    }
+
+    unsigned int baseSeed = options.seed != 0 ? options.seed : static_cast<unsigned int>(rng());
+
+    auto worker = [&](int id)
+    {
+        std::mt19937 random(baseSeed + id);
+        MinimalSearchResult local;
+
+        auto record = [&](const SudokuBoard &puzzle, int clues)
+        {
+            local.minimalPuzzles++;
+            local.clueCounts[clues]++;
+            if (clues < local.bestClues)
+            {
+                local.bestClues = clues;
+                local.best = puzzle;
+            }
+            if (clues <= options.targetClues)
+            {
+                local.puzzles.push_back(puzzle);
+                found++;
+            }
+        };
+        auto finished = [&]()
+        {
+            return found.load() >= options.maxResults || Clock::now() >= deadline;
+        };
+
+        SudokuBoard solution;
+        for (long long round = 0; !finished(); round++)
+        {
+            if (round % LOW_CLUE_FRESH_GRIDS == 0)
+            {
+                solution = generateBySearch(random);
+            }
+            else
+            {
+                generateComplete(solution, random);
+            }
+            SudokuBoard puzzle = solution;
+            int clues = reduceToMinimal(puzzle, random);
+            record(puzzle, clues);
+
+            for (int step = 0; step < options.improvementSteps && !finished(); step++)
+            {
+                // Swap one clue for a currently empty cell taken from the solution
+                int drop = 0;
+                int add = 0;
+                do
+                {
+                    drop = static_cast<int>(random() % 81);
+                } while (puzzle.isEmpty(drop / 9, drop % 9));
+                do
+                {
+                    add = static_cast<int>(random() % 81);
+                } while (!puzzle.isEmpty(add / 9, add % 9));
+
+                SudokuBoard candidate = puzzle;
+                candidate.getBoard()[drop / 9][drop % 9] = 0;
+                candidate.getBoard()[add / 9][add % 9] = solution.getValue(add / 9, add % 9);
+                if (SudokuSolver::countSolutions(candidate, 2) != 1)
+                {
+                    continue;
+                }
+
+                int candidateClues = reduceToMinimal(candidate, random);
+                record(candidate, candidateClues);
+                if (candidateClues <= clues)
+                {
+                    puzzle = candidate;
+                    clues = candidateClues;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(resultMutex);
+        result.minimalPuzzles += local.minimalPuzzles;
+        for (int i = 0; i < 82; i++)
+        {
+            result.clueCounts[i] += local.clueCounts[i];
+        }
+        if (local.bestClues < result.bestClues)
+        {
+            result.bestClues = local.bestClues;
+            result.best = local.best;
+        }
+        for (auto &puzzle : local.puzzles)
+        {
+            if (static_cast<int>(result.puzzles.size()) < options.maxResults)
+            {
+                result.puzzles.push_back(puzzle);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int id = 1; id < threadCount; id++)
+    {
+        workers.emplace_back(worker, id);
+    }
+    worker(0);
+    for (auto &thread : workers)
+    {
+        thread.join();
+    }
+
+    result.elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
 SudokuBoard SudokuGenerator::generateComplete()
 {
+    return generateComplete(gridSource);
+}
+
+SudokuBoard SudokuGenerator::generateComplete(GridSource source)
+{
+    if (source == GridSource::SEARCH)
+    {
+        return generateBySearch(rng);
+    }
+
     SudokuBoard board;
+    transformSeedGrid(board, rng);
+    return board;
+}
+
+void SudokuGenerator::generateComplete(SudokuBoard &board)
+{
+    generateComplete(board, rng);
+}
 
-    // Fill diagonal 3x3 boxes first (they don't interfere with each other)
-    for (int box = 0; box < 3; box++)
+void SudokuGenerator::generateComplete(SudokuBoard &board, std::mt19937 &random)
+{
+    if (gridSource == GridSource::SEARCH)
     {
-        fillDiagonalBox(board, box * 3, box * 3);
+        board = generateBySearch(random);
+        return;
     }
+    transformSeedGrid(board, random);
+}
 
-    // Fill remaining cells
-    if (SudokuSolver::solve(board))
+SudokuBoard SudokuGenerator::generateBySearch(std::mt19937 &random)
+{
+    SudokuBoard board;
+
+    while (true)
     {
-        return board;
+        // Fill diagonal 3x3 boxes first (they don't interfere with each other)
+        for (int box = 0; box < 3; box++)
+        {
+            fillDiagonalBox(board, box * 3, box * 3, random);
+        }
+
+        // Fill remaining cells
+        if (fillBoard(board))
+        {
+            return board;
+        }
+
+        // If somehow we can't solve, try again (very rare)
+        board.clear();
     }
+}
 
-    // If somehow we can't solve, try again (very rare)
-    return generateComplete();
+std::vector<SudokuGenerator::Grid> SudokuGenerator::builtinSeedGrids()
+{
+    std::vector<Grid> grids;
+    for (const char *line : BUILTIN_SEED_GRIDS)
+    {
+        Grid grid;
+        parseSeedGrid(line, grid);
+        grids.push_back(grid);
+    }
+    return grids;
 }
 
-void SudokuGenerator::fillDiagonalBox(SudokuBoard &board, int row, int col)
+void SudokuGenerator::transformSeedGrid(SudokuBoard &board, std::mt19937 &random)
+{
+    // One 64-bit draw covers every choice: seed grid, digit relabel (9!),
+    // band/stack and row/column orders (6^8) and transpose (2). That is about
+    // 2^40.2 per seed grid, so about 2^43.2 with the 8 built-in ones; 64 bits
+    // leave room for some 15 million loaded seed grids
+    uint64_t code = (static_cast<uint64_t>(random()) << 32) | random();
+
+    const Grid &seed = seedGrids[code % seedGrids.size()];
+    code /= seedGrids.size();
+
+    uint8_t digits[9];
+    takePermutation(code, 9, digits);
+
+    uint8_t rowMap[9];
+    uint8_t colMap[9];
+    takeLineMap(code, rowMap);
+    takeLineMap(code, colMap);
+
+    bool transpose = (code & 1) != 0;
+    int rowStride = transpose ? 1 : 9;
+    int colStride = transpose ? 9 : 1;
+
+    auto &cells = board.getBoard();
+    for (int i = 0; i < 9; i++)
+    {
+        const uint8_t *source = seed.data() + rowMap[i] * rowStride;
+        std::vector<int> &row = cells[i];
+        for (int j = 0; j < 9; j++)
+        {
+            row[j] = digits[source[colMap[j] * colStride] - 1] + 1;
+        }
+    }
+}
+
+bool SudokuGenerator::parseSeedGrid(const std::string &line, Grid &grid)
+{
+    if (line.size() < 81)
+    {
+        return false;
+    }
+
+    int rowMasks[9] = {0};
+    int colMasks[9] = {0};
+    int boxMasks[9] = {0};
+
+    for (int i = 0; i < 81; i++)
+    {
+        char ch = line[i];
+        if (ch < '1' || ch > '9')
+        {
+            return false;
+        }
+
+        int row = i / 9;
+        int col = i % 9;
+        int box = (row / 3) * 3 + col / 3;
+        int bit = 1 << (ch - '1');
+
+        if ((rowMasks[row] | colMasks[col] | boxMasks[box]) & bit)
+        {
+            return false; // Duplicate digit in a unit
+        }
+
+        rowMasks[row] |= bit;
+        colMasks[col] |= bit;
+        boxMasks[box] |= bit;
+        grid[i] = static_cast<uint8_t>(ch - '0');
+    }
+
+    return true;
+}
+
+bool SudokuGenerator::loadSeedGrids(const std::string &filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    std::vector<Grid> grids;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        Grid grid;
+        if (parseSeedGrid(line, grid))
+        {
+            grids.push_back(grid);
+        }
+    }
+
+    if (grids.empty())
+    {
+        return false;
+    }
+
+    seedGrids = std::move(grids);
+    return true;
+}
+
+size_t SudokuGenerator::seedGridCount()
+{
+    return seedGrids.size();
+}
+
+void SudokuGenerator::setGridSource(GridSource source)
+{
+    gridSource = source;
+}
+
+void SudokuGenerator::fillDiagonalBox(SudokuBoard &board, int row, int col, std::mt19937 &random)
 {
     std::vector<int> numbers = {1, 2, 3, 4, 5, 6, 7, 8, 9};
-    std::shuffle(numbers.begin(), numbers.end(), rng);
+    std::shuffle(numbers.begin(), numbers.end(), random);
 
     int index = 0;
     for (int i = 0; i < 3; i++)
@@ -76,43 +674,35 @@ bool SudokuGenerator::fillBoard(SudokuBoard &board)
     return SudokuSolver::solve(board);
 }
 
-void SudokuGenerator::removeCells(SudokuBoard &board, int cellsToRemove)
+void SudokuGenerator::removeCells(SudokuBoard &board, int cellsToRemove, Symmetry symmetry, std::mt19937 &random)
 {
-    // Create list of all cell positions
-    std::vector<std::pair<int, int>> positions;
-    for (int i = 0; i < 9; i++)
-    {
-        for (int j = 0; j < 9; j++)
-        {
-            positions.push_back({i, j});
-        }
-    }
+    // Group cell positions into symmetry orbits (single cells without symmetry)
+    Orbit orbits[81];
+    int orbitCount = buildOrbits(symmetry, orbits);
 
-    // Shuffle positions
-    std::shuffle(positions.begin(), positions.end(), rng);
+    // Shuffle orbits
+    std::shuffle(orbits, orbits + orbitCount, random);
 
+    auto &cells = board.getBoard();
     int removed = 0;
-    for (auto &pos : positions)
+    for (int i = 0; i < orbitCount; i++)
     {
         if (removed >= cellsToRemove)
             break;
 
-        int row = pos.first;
-        int col = pos.second;
-        int backup = board.getValue(row, col);
-
-        // Temporarily remove the cell
-        board.getBoard()[row][col] = 0;
+        // Temporarily remove the whole orbit
+        int backup[4];
+        clearOrbit(cells, orbits[i], backup);
 
         // Check if puzzle still has unique solution
-        if (hasUniqueSolution(board))
+        if (stillUnique(board, orbits[i], backup))
         {
-            removed++;
+            removed += orbits[i].size;
         }
         else
         {
-            // Restore the cell if removing it makes puzzle non-unique
-            board.getBoard()[row][col] = backup;
+            // Restore the orbit if removing it makes puzzle non-unique
+            restoreOrbit(cells, orbits[i], backup);
         }
     }
 }
@@ -122,27 +712,9 @@ bool SudokuGenerator::hasUniqueSolution(const SudokuBoard &board)
     return countSolutions(board, 2) == 1;
 }
 
-int SudokuGenerator::countSolutions(SudokuBoard board, int maxSolutions)
+int SudokuGenerator::countSolutions(const SudokuBoard &board, int maxSolutions)
 {
-    int row, col;
-    if (!SudokuSolver::findEmptyCell(board, row, col))
-    {
-        return 1; // Puzzle is complete
-    }
-
-    int solutionCount = 0;
-
-    for (int num = 1; num <= 9 && solutionCount < maxSolutions; num++)
-    {
-        if (board.isValidMove(row, col, num))
-        {
-            board.getBoard()[row][col] = num;
-            solutionCount += countSolutions(board, maxSolutions - solutionCount);
-            board.getBoard()[row][col] = 0;
-        }
-    }
-
-    return solutionCount;
+    return SudokuSolver::countSolutions(board, maxSolutions);
 }
 
 void SudokuGenerator::setSeed(unsigned int seed)
@@ -0,0 +1,145 @@
+#include "SudokuHistogram.hpp"
+#include <cstdio>
+
+namespace
+{
+    // Index of the highest set bit; value must be non-zero
+    int highestBit(uint64_t value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(value);
+#else
+        int bit = 0;
+        while (value >>= 1)
+        {
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    const int SUB_BITS = 4; // log2(SUB_BUCKETS)
+}
+
+SudokuHistogram::SudokuHistogram()
+{
+    clear();
+}
+
+void SudokuHistogram::clear()
+{
+    counts.fill(0);
+    samples = 0;
+    smallest = UINT64_MAX;
+    largest = 0;
+    total = 0;
+}
+
+int SudokuHistogram::bucketOf(uint64_t value)
+{
+    if (value < static_cast<uint64_t>(SUB_BUCKETS))
+    {
+        return static_cast<int>(value);
+    }
+    // Top SUB_BITS bits below the leading one pick the linear step within the octave
+    int exponent = highestBit(value);
+    int step = static_cast<int>((value >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1));
+    return (exponent - SUB_BITS + 1) * SUB_BUCKETS + step;
+}
+
+uint64_t SudokuHistogram::bucketTop(int bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return static_cast<uint64_t>(bucket);
+    }
+    int shift = bucket / SUB_BUCKETS - 1;
+    uint64_t step = static_cast<uint64_t>(bucket % SUB_BUCKETS);
+    uint64_t bottom = (static_cast<uint64_t>(SUB_BUCKETS) + step) << shift;
+    return bottom + ((uint64_t(1) << shift) - 1);
+}
+
+void SudokuHistogram::record(uint64_t value)
+{
+    counts[bucketOf(value)]++;
+    samples++;
+    total += value;
+    if (value < smallest)
+    {
+        smallest = value;
+    }
+    if (value > largest)
+    {
+        largest = value;
+    }
+}
+
+void SudokuHistogram::merge(const SudokuHistogram &other)
+{
+    for (int i = 0; i < BUCKETS; i++)
+    {
+        counts[i] += other.counts[i];
+    }
+    samples += other.samples;
+    total += other.total;
+    if (other.smallest < smallest)
+    {
+        smallest = other.smallest;
+    }
+    if (other.largest > largest)
+    {
+        largest = other.largest;
+    }
+}
+
+uint64_t SudokuHistogram::percentile(double q) const
+{
+    if (samples == 0)
+    {
+        return 0;
+    }
+
+    // Rank of the sample we want, 1-based
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(samples) + 0.5);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+    if (rank > samples)
+    {
+        rank = samples;
+    }
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+        {
+            uint64_t top = bucketTop(i);
+            return top < largest ? top : largest;
+        }
+    }
+    return largest;
+}
+
+std::string SudokuHistogram::formatNanos(uint64_t nanos)
+{
+    char text[32];
+    if (nanos < 1000)
+        std::snprintf(text, sizeof(text), "%lluns", static_cast<unsigned long long>(nanos));
+    else if (nanos < 1000000)
+        std::snprintf(text, sizeof(text), "%.1fus", nanos / 1e3);
+    else if (nanos < 1000000000)
+        std::snprintf(text, sizeof(text), "%.2fms", nanos / 1e6);
+    else
+        std::snprintf(text, sizeof(text), "%.2fs", nanos / 1e9);
+    return text;
+}
+
+std::string SudokuHistogram::summary() const
+{
+    return "p50 " + formatNanos(percentile(0.50)) + ", p90 " + formatNanos(percentile(0.90)) + ", p99 " +
+           formatNanos(percentile(0.99)) + ", p99.9 " + formatNanos(percentile(0.999)) + ", max " +
+           formatNanos(max());
+}
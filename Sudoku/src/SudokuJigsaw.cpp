@@ -0,0 +1,195 @@
+#include "SudokuJigsaw.hpp"
+#include <cctype>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+JigsawGeometry::PeerTable JigsawGeometry::makePeers(const std::array<uint8_t, CELLS> &layout)
+{
+    PeerTable peers{};
+    for (int cell = 0; cell < CELLS; cell++)
+    {
+        int row = rowOf(cell);
+        int col = colOf(cell);
+        int count = 0;
+        for (int i = 0; i < SIZE; i++)
+        {
+            if (i != col)
+            {
+                peers[cell][count++] = static_cast<Cell>(row * SIZE + i);
+            }
+        }
+        for (int i = 0; i < SIZE; i++)
+        {
+            if (i != row)
+            {
+                peers[cell][count++] = static_cast<Cell>(i * SIZE + col);
+            }
+        }
+        for (int other = 0; other < CELLS; other++)
+        {
+            if (layout[other] == layout[cell] && rowOf(other) != row && colOf(other) != col)
+            {
+                peers[cell][count++] = static_cast<Cell>(other);
+            }
+        }
+        for (; count < PEER_COUNT; count++)
+        {
+            peers[cell][count] = peers[cell][0];
+        }
+    }
+    return peers;
+}
+
+std::string JigsawGeometry::unitName(int unit)
+{
+    if (unit < 2 * SIZE)
+    {
+        return Geometry9::unitName(unit);
+    }
+    return "region " + std::to_string(unit - 2 * SIZE + 1);
+}
+
+bool SudokuJigsaw::parseLayout(const std::string &text, Layout &layout, std::string &error)
+{
+    std::string labels;
+    int count = 0;
+    for (char c : text)
+    {
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            continue;
+        }
+        if (count == 81)
+        {
+            error = "more than 81 cells";
+            return false;
+        }
+        size_t region = labels.find(c);
+        if (region == std::string::npos)
+        {
+            if (labels.size() == 9)
+            {
+                error = std::string("more than 9 regions (label '") + c + "')";
+                return false;
+            }
+            region = labels.size();
+            labels += c;
+        }
+        layout[count++] = static_cast<uint8_t>(region);
+    }
+    if (count != 81)
+    {
+        error = "expected 81 cells, found " + std::to_string(count);
+        return false;
+    }
+    return validateLayout(layout, error);
+}
+
+bool SudokuJigsaw::validateLayout(const Layout &layout, std::string &error)
+{
+    int sizes[9] = {};
+    for (uint8_t region : layout)
+    {
+        if (region >= 9)
+        {
+            error = "region number above 8";
+            return false;
+        }
+        sizes[region]++;
+    }
+    for (int region = 0; region < 9; region++)
+    {
+        if (sizes[region] != 9)
+        {
+            error = "region " + std::to_string(region + 1) + " has " + std::to_string(sizes[region]) + " cells";
+            return false;
+        }
+    }
+
+    // Flood each region from its first cell; every cell must be reached
+    bool reached[81] = {};
+    for (int region = 0; region < 9; region++)
+    {
+        int stack[81];
+        int top = 0;
+        int first = 0;
+        while (layout[first] != region)
+        {
+            first++;
+        }
+        stack[top++] = first;
+        reached[first] = true;
+        int found = 0;
+        while (top > 0)
+        {
+            int cell = stack[--top];
+            found++;
+            int row = cell / 9;
+            int col = cell % 9;
+            const int neighbours[4] = {row > 0 ? cell - 9 : -1, row < 8 ? cell + 9 : -1, col > 0 ? cell - 1 : -1,
+                                       col < 8 ? cell + 1 : -1};
+            for (int next : neighbours)
+            {
+                if (next >= 0 && !reached[next] && layout[next] == region)
+                {
+                    reached[next] = true;
+                    stack[top++] = next;
+                }
+            }
+        }
+        if (found != 9)
+        {
+            error = "region " + std::to_string(region + 1) + " is not connected";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SudokuJigsaw::install(const Layout &layout, std::string &error)
+{
+    static std::mutex mutex;
+    static bool installed = false;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (installed)
+    {
+        if (JigsawGeometry::regions == layout)
+        {
+            return true;
+        }
+        error = "another layout is already in use (one layout per process)";
+        return false;
+    }
+
+    JigsawGeometry::regions = layout;
+    auto &units = GRID_UNITS<JigsawGeometry>;
+    int filled[9] = {};
+    for (int cell = 0; cell < 81; cell++)
+    {
+        int region = layout[cell];
+        units[18 + region][filled[region]++] = static_cast<JigsawGeometry::Cell>(cell);
+    }
+    GRID_PEERS<JigsawGeometry> = JigsawGeometry::makePeers(layout);
+    installed = true;
+    return true;
+}
+
+bool SudokuJigsaw::loadLayout(const std::string &filename, std::string &error)
+{
+    std::ifstream file(filename);
+    if (!file)
+    {
+        error = "cannot open " + filename;
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+
+    Layout layout;
+    if (!parseLayout(text.str(), layout, error))
+    {
+        return false;
+    }
+    return install(layout, error);
+}
@@ -0,0 +1,291 @@
+#include "SudokuJournal.hpp"
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char MAGIC[8] = {'S', 'D', 'K', 'J', 'R', 'N', 'L', '1'};
+    const int HEADER_SIZE = sizeof(MAGIC) + 1 + SudokuBoard::PACKED_SIZE;
+
+    const unsigned char PUZZLE_RECORD = 'P';
+    const unsigned char MOVE_RECORD = 'M';
+    const unsigned char CHAINED_RECORD = 'C';
+    const unsigned char UNDO_RECORD = 'U';
+    const unsigned char REDO_RECORD = 'R';
+
+    // Force written data out of the OS cache
+    void syncFile(std::FILE *file)
+    {
+#ifdef _WIN32
+        _commit(_fileno(file));
+#else
+        fsync(fileno(file));
+#endif
+    }
+
+    // Apply a move to the board in the given direction
+    void applyMove(SudokuBoard &board, const Move &move, bool forward)
+    {
+        board.getBoard()[move.cell / 9][move.cell % 9] = forward ? move.newValue : move.oldValue;
+    }
+}
+
+SudokuJournal::SudokuJournal() : file(nullptr), unsynced(false), stopping(false)
+{
+}
+
+SudokuJournal::~SudokuJournal()
+{
+    close();
+    if (syncer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        syncer.join();
+    }
+}
+
+void SudokuJournal::sync()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    syncLocked();
+}
+
+void SudokuJournal::syncLocked()
+{
+    if (file != nullptr && unsynced)
+    {
+        syncFile(file);
+    }
+    unsynced = false;
+    lastSync = std::chrono::steady_clock::now();
+}
+
+void SudokuJournal::syncLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping)
+    {
+        if (!unsynced)
+        {
+            wake.wait(lock);
+        }
+        else if (std::chrono::steady_clock::now() < lastSync + SYNC_INTERVAL)
+        {
+            wake.wait_until(lock, lastSync + SYNC_INTERVAL);
+        }
+        else
+        {
+            syncLocked();
+        }
+    }
+}
+
+void SudokuJournal::close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file != nullptr)
+    {
+        syncLocked();
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+bool SudokuJournal::openForAppend(const std::string &filename)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        file = std::fopen(filename.c_str(), "ab");
+        unsynced = false;
+        lastSync = std::chrono::steady_clock::now();
+    }
+    if (file != nullptr && !syncer.joinable())
+    {
+        syncer = std::thread(&SudokuJournal::syncLoop, this);
+    }
+    return file != nullptr;
+}
+
+bool SudokuJournal::begin(const std::string &filename, const SudokuBoard &puzzle)
+{
+    close();
+
+    unsigned char header[HEADER_SIZE];
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    header[sizeof(MAGIC)] = PUZZLE_RECORD;
+    puzzle.encodePacked(header + sizeof(MAGIC) + 1);
+
+    // Write beside the old journal and swap it in once the header is durable
+    std::string temporary = filename + ".tmp";
+    std::FILE *out = std::fopen(temporary.c_str(), "wb");
+    if (out == nullptr)
+    {
+        return false;
+    }
+    bool ok = std::fwrite(header, sizeof(header), 1, out) == 1 && std::fflush(out) == 0;
+    if (ok)
+    {
+        syncFile(out);
+    }
+    std::fclose(out);
+
+    std::error_code error;
+    if (ok)
+    {
+        std::filesystem::rename(temporary, filename, error);
+    }
+    if (!ok || error)
+    {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    return openForAppend(filename);
+}
+
+bool SudokuJournal::resume(const std::string &filename, long validLength)
+{
+    close();
+
+    // Cut off a torn record so new ones start on a record boundary
+    std::error_code error;
+    if (std::filesystem::file_size(filename, error) != static_cast<uintmax_t>(validLength))
+    {
+        std::filesystem::resize_file(filename, validLength, error);
+        if (error)
+        {
+            return false;
+        }
+    }
+
+    return openForAppend(filename);
+}
+
+bool SudokuJournal::appendMove(const Move &move)
+{
+    const unsigned char record[4] = {move.chained ? CHAINED_RECORD : MOVE_RECORD, move.cell, move.oldValue,
+                                     static_cast<unsigned char>(move.newValue)};
+    return append(record, sizeof(record));
+}
+
+bool SudokuJournal::appendUndo()
+{
+    return append(&UNDO_RECORD, 1);
+}
+
+bool SudokuJournal::appendRedo()
+{
+    return append(&REDO_RECORD, 1);
+}
+
+bool SudokuJournal::append(const unsigned char *record, size_t size)
+{
+    bool waking;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        // One fwrite into the stdio buffer and one flush: a single write() per record
+        if (std::fwrite(record, size, 1, file) != 1 || std::fflush(file) != 0)
+        {
+            std::fclose(file);
+            file = nullptr;
+            return false;
+        }
+        waking = !unsynced;
+        unsynced = true;
+    }
+    if (waking)
+    {
+        wake.notify_one();
+    }
+    return true;
+}
+
+bool SudokuJournal::replay(const std::string &filename, SudokuBoard &puzzle, SudokuBoard &board,
+                           SudokuMoveHistory &history, long &validLength)
+{
+    std::FILE *in = std::fopen(filename.c_str(), "rb");
+    if (in == nullptr)
+    {
+        return false;
+    }
+
+    std::vector<unsigned char> data;
+    unsigned char chunk[4096];
+    size_t bytes;
+    while ((bytes = std::fread(chunk, 1, sizeof(chunk), in)) > 0)
+    {
+        data.insert(data.end(), chunk, chunk + bytes);
+    }
+    std::fclose(in);
+
+    if (data.size() < static_cast<size_t>(HEADER_SIZE) || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0 ||
+        data[sizeof(MAGIC)] != PUZZLE_RECORD || !puzzle.decodePacked(&data[sizeof(MAGIC) + 1]))
+    {
+        return false;
+    }
+
+    board = puzzle;
+    history.clear();
+
+    size_t position = HEADER_SIZE;
+    while (position < data.size())
+    {
+        Move move;
+        unsigned char type = data[position];
+        if (type == MOVE_RECORD || type == CHAINED_RECORD)
+        {
+            if (position + 4 > data.size())
+            {
+                break; // Torn write
+            }
+            if (data[position + 1] >= 81 || data[position + 2] > 9 || data[position + 3] > 9)
+            {
+                break;
+            }
+            move = Move{data[position + 1], data[position + 2], data[position + 3], type == CHAINED_RECORD};
+            applyMove(board, move, true);
+            history.record(move);
+            position += 4;
+        }
+        else if (type == UNDO_RECORD)
+        {
+            if (history.undo(move))
+            {
+                applyMove(board, move, false);
+            }
+            position++;
+        }
+        else if (type == REDO_RECORD)
+        {
+            if (history.redo(move))
+            {
+                applyMove(board, move, true);
+            }
+            position++;
+        }
+        else
+        {
+            break; // Garbage after a crash
+        }
+    }
+
+    validLength = static_cast<long>(position);
+    return true;
+}
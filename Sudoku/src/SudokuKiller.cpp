@@ -0,0 +1,223 @@
+#include "SudokuKiller.hpp"
+#include "SudokuLineReader.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <sstream>
+
+namespace
+{
+    // strtol into an int in [0, limit]; false on no digits or a value out of
+    // range, checked before narrowing so that a huge number cannot wrap into range
+    bool readNumber(const char *text, char *&end, long limit, int &value)
+    {
+        errno = 0;
+        long number = std::strtol(text, &end, 10);
+        if (end == text || errno == ERANGE || number < 0 || number > limit)
+        {
+            return false;
+        }
+        value = static_cast<int>(number);
+        return true;
+    }
+}
+
+SudokuKiller::SudokuKiller()
+{
+    cageIndex.fill(NO_CAGE);
+}
+
+bool SudokuKiller::addCage(int sum, const std::vector<int> &cells)
+{
+    int size = static_cast<int>(cells.size());
+    if (size == 0 || size > MAX_CAGE_SIZE)
+    {
+        return false;
+    }
+    // Distinct digits reach every sum from 1 + ... + size up to 9 + ... + (10 - size)
+    int smallest = size * (size + 1) / 2;
+    int largest = size * (19 - size) / 2;
+    if (sum < smallest || sum > largest)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        if (cells[i] < 0 || cells[i] >= 81 || cageIndex[cells[i]] != NO_CAGE)
+        {
+            return false;
+        }
+        for (size_t j = 0; j < i; j++)
+        {
+            if (cells[j] == cells[i])
+            {
+                return false;
+            }
+        }
+    }
+
+    for (int cell : cells)
+    {
+        cageIndex[cell] = static_cast<int8_t>(cages.size());
+    }
+    cages.push_back(KillerCage{sum, cells});
+    return true;
+}
+
+void SudokuKiller::clearCages()
+{
+    cages.clear();
+    cageIndex.fill(NO_CAGE);
+}
+
+bool SudokuKiller::coversBoard() const
+{
+    for (int8_t cage : cageIndex)
+    {
+        if (cage == NO_CAGE)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SudokuKiller::cageAllows(const uint8_t *cells, int cage) const
+{
+    const KillerCage &killerCage = cages[cage];
+    unsigned seen = 0;
+    int total = 0;
+    bool full = true;
+    for (int cell : killerCage.cells)
+    {
+        int value = cells[cell];
+        if (value == 0)
+        {
+            full = false;
+            continue;
+        }
+        if (seen & (1u << value))
+        {
+            return false;
+        }
+        seen |= 1u << value;
+        total += value;
+    }
+    return full ? total == killerCage.sum : total < killerCage.sum;
+}
+
+bool SudokuKiller::isValidMove(const SudokuBoard &board, int row, int col, int value) const
+{
+    if (!board.isValidMove(row, col, value))
+    {
+        return false;
+    }
+    int cage = cageIndex[row * 9 + col];
+    if (cage == NO_CAGE)
+    {
+        return true;
+    }
+
+    uint8_t cells[81];
+    for (int cell : cages[cage].cells)
+    {
+        cells[cell] = static_cast<uint8_t>(board.getValue(cell / 9, cell % 9));
+    }
+    cells[row * 9 + col] = static_cast<uint8_t>(value);
+    return cageAllows(cells, cage);
+}
+
+int SudokuKiller::firstBrokenCage(const SudokuBoard &board) const
+{
+    uint8_t cells[81];
+    for (int cell = 0; cell < 81; cell++)
+    {
+        cells[cell] = static_cast<uint8_t>(board.getValue(cell / 9, cell % 9));
+    }
+    for (int cage = 0; cage < static_cast<int>(cages.size()); cage++)
+    {
+        if (!cageAllows(cells, cage))
+        {
+            return cage;
+        }
+    }
+    return NO_CAGE;
+}
+
+bool SudokuKiller::parse(const std::string &line)
+{
+    uint8_t cells[81];
+    if (line.size() < 81 || !SudokuLineReader::parseLine(line.data(), 81, cells))
+    {
+        return false;
+    }
+
+    SudokuKiller parsed;
+    std::istringstream fields(line.substr(81));
+    std::string field;
+    while (fields >> field)
+    {
+        size_t colon = field.find(':');
+        if (colon == std::string::npos || colon == 0)
+        {
+            return false;
+        }
+        char *end = nullptr;
+        int sum;
+        if (!readNumber(field.c_str(), end, 45, sum) || end != field.c_str() + colon)
+        {
+            return false;
+        }
+
+        std::vector<int> cageCells;
+        const char *next = field.c_str() + colon + 1;
+        for (;;)
+        {
+            int cell;
+            if (!readNumber(next, end, 80, cell))
+            {
+                return false;
+            }
+            cageCells.push_back(cell);
+            if (*end == '\0')
+            {
+                break;
+            }
+            if (*end != ',')
+            {
+                return false;
+            }
+            next = end + 1;
+        }
+        if (!parsed.addCage(sum, cageCells))
+        {
+            return false;
+        }
+    }
+
+    auto &rows = parsed.givens.getBoard();
+    for (int cell = 0; cell < 81; cell++)
+    {
+        rows[cell / 9][cell % 9] = cells[cell];
+    }
+    *this = parsed;
+    return true;
+}
+
+std::string SudokuKiller::format() const
+{
+    std::string text(81, '.');
+    givens.formatLine(&text[0]);
+    for (const KillerCage &cage : cages)
+    {
+        text += ' ';
+        text += std::to_string(cage.sum);
+        char separator = ':';
+        for (int cell : cage.cells)
+        {
+            text += separator;
+            text += std::to_string(cell);
+            separator = ',';
+        }
+    }
+    return text;
+}
@@ -0,0 +1,145 @@
+#include "SudokuKillerGenerator.hpp"
+#include "SudokuGridGenerator.hpp"
+#include "SudokuKillerSolver.hpp"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+SudokuKiller SudokuKillerGenerator::generatePuzzle(Difficulty difficulty, std::mt19937 &random,
+                                                   KillerGenerationStats *stats)
+{
+    SudokuGrid<Geometry9> grid = SudokuGridGenerator<Geometry9>::generateComplete(random);
+    const uint8_t *solution = grid.data();
+
+    SudokuKiller puzzle;
+    cutCages(solution, maxCageSize(difficulty), random, puzzle);
+
+    KillerGenerationStats local;
+    KillerGenerationStats &work = stats ? *stats : local;
+    auto &givens = puzzle.getGivens().getBoard();
+    uint8_t other[81];
+
+    // Pin cells down until no second solution is left
+    for (;;)
+    {
+        SolverStats search;
+        work.uniquenessChecks++;
+        bool ambiguous = SudokuKillerSolver::findOtherSolution(puzzle, solution, other, &search);
+        work.nodes += search.nodes;
+        if (!ambiguous)
+        {
+            break;
+        }
+        std::vector<int> differing;
+        for (int cell = 0; cell < 81; cell++)
+        {
+            if (other[cell] != solution[cell])
+            {
+                differing.push_back(cell);
+            }
+        }
+        int cell = differing[std::uniform_int_distribution<size_t>(0, differing.size() - 1)(random)];
+        givens[cell / 9][cell % 9] = solution[cell];
+    }
+
+    if (difficulty != Difficulty::EASY)
+    {
+        std::vector<int> order(81);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), random);
+        for (int cell : order)
+        {
+            int &given = givens[cell / 9][cell % 9];
+            if (given == 0)
+            {
+                continue;
+            }
+            given = 0;
+            SolverStats search;
+            work.uniquenessChecks++;
+            if (SudokuKillerSolver::findOtherSolution(puzzle, solution, other, &search))
+            {
+                given = solution[cell];
+            }
+            work.nodes += search.nodes;
+        }
+    }
+
+    work.givens = 0;
+    for (int cell = 0; cell < 81; cell++)
+    {
+        work.givens += givens[cell / 9][cell % 9] != 0;
+    }
+    return puzzle;
+}
+
+int SudokuKillerGenerator::maxCageSize(Difficulty difficulty)
+{
+    switch (difficulty)
+    {
+    case Difficulty::EASY:
+        return 3;
+    case Difficulty::MEDIUM:
+        return 4;
+    case Difficulty::HARD:
+        return 5;
+    }
+    return 4;
+}
+
+void SudokuKillerGenerator::cutCages(const uint8_t *solution, int maxSize, std::mt19937 &random,
+                                     SudokuKiller &puzzle)
+{
+    std::vector<int> order(81);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), random);
+
+    bool caged[81] = {};
+    std::uniform_int_distribution<int> sizes(2, maxSize);
+    for (int start : order)
+    {
+        if (caged[start])
+        {
+            continue;
+        }
+        std::vector<int> cells{start};
+        unsigned digits = 1u << solution[start];
+        caged[start] = true;
+
+        // Grow from a random edge of the cage while it has room and a neighbour fits
+        int size = sizes(random);
+        while (static_cast<int>(cells.size()) < size)
+        {
+            std::vector<int> edge;
+            for (int cell : cells)
+            {
+                int row = cell / 9;
+                int col = cell % 9;
+                const int neighbours[4] = {row > 0 ? cell - 9 : -1, row < 8 ? cell + 9 : -1,
+                                           col > 0 ? cell - 1 : -1, col < 8 ? cell + 1 : -1};
+                for (int next : neighbours)
+                {
+                    if (next >= 0 && !caged[next] && !(digits & (1u << solution[next])))
+                    {
+                        edge.push_back(next);
+                    }
+                }
+            }
+            if (edge.empty())
+            {
+                break;
+            }
+            int next = edge[std::uniform_int_distribution<size_t>(0, edge.size() - 1)(random)];
+            cells.push_back(next);
+            digits |= 1u << solution[next];
+            caged[next] = true;
+        }
+
+        int sum = 0;
+        for (int cell : cells)
+        {
+            sum += solution[cell];
+        }
+        puzzle.addCage(sum, cells);
+    }
+}
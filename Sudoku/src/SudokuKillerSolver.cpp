@@ -0,0 +1,339 @@
+#include "SudokuKillerSolver.hpp"
+#include "SudokuBits.hpp"
+#include "SudokuGridSolver.hpp"
+#include <algorithm>
+#include <vector>
+
+using namespace SudokuBits;
+
+namespace
+{
+    // Per (size, sum, allowed digits): the digits of any fitting combination and
+    // the digits of all of them. Sums of distinct digits stop at 45.
+    struct CombinationTable
+    {
+        uint16_t any[10][46][512];
+        uint16_t all[10][46][512];
+
+        CombinationTable()
+        {
+            for (int size = 0; size < 10; size++)
+            {
+                for (int sum = 0; sum < 46; sum++)
+                {
+                    for (int allowed = 0; allowed < 512; allowed++)
+                    {
+                        any[size][sum][allowed] = 0;
+                        all[size][sum][allowed] = ALL_DIGITS;
+                    }
+                }
+            }
+
+            // Every set of digits is a combination for each allowed mask that contains it
+            int setSum[512];
+            setSum[0] = 0;
+            for (int set = 1; set < 512; set++)
+            {
+                setSum[set] = setSum[set & (set - 1)] + lowestBit(set) + 1;
+            }
+            for (int allowed = 0; allowed < 512; allowed++)
+            {
+                for (int set = allowed;; set = (set - 1) & allowed)
+                {
+                    int size = popCount(set);
+                    any[size][setSum[set]][allowed] |= static_cast<uint16_t>(set);
+                    all[size][setSum[set]][allowed] &= static_cast<uint16_t>(set);
+                    if (set == 0)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            // No combination: nothing is required either
+            for (int size = 0; size < 10; size++)
+            {
+                for (int sum = 0; sum < 46; sum++)
+                {
+                    for (int allowed = 0; allowed < 512; allowed++)
+                    {
+                        if (any[size][sum][allowed] == 0)
+                        {
+                            all[size][sum][allowed] = 0;
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    const CombinationTable &combinations()
+    {
+        static const CombinationTable table;
+        return table;
+    }
+
+    // The cages in flat arrays for the search
+    struct Cages
+    {
+        int count = 0;
+        int8_t cageOf[81];
+        uint8_t size[81];
+        uint8_t sum[81];
+        uint8_t cells[81][9];
+    };
+
+    void loadCages(const SudokuKiller &puzzle, Cages &cages)
+    {
+        cages.count = 0;
+        for (int cell = 0; cell < 81; cell++)
+        {
+            cages.cageOf[cell] = static_cast<int8_t>(puzzle.cageOf(cell));
+        }
+        for (const KillerCage &cage : puzzle.getCages())
+        {
+            cages.size[cages.count] = static_cast<uint8_t>(cage.cells.size());
+            cages.sum[cages.count] = static_cast<uint8_t>(cage.sum);
+            for (size_t i = 0; i < cage.cells.size(); i++)
+            {
+                cages.cells[cages.count][i] = static_cast<uint8_t>(cage.cells[i]);
+            }
+            cages.count++;
+        }
+    }
+
+    template <typename Failure>
+    bool fail(Failure *failure, SolveResult result, int cell, int digit)
+    {
+        if (failure)
+        {
+            *failure = Failure{result, cell, -1, digit};
+        }
+        return false;
+    }
+
+    // The cage rules as a propagation step of the grid solver: digits placed in a
+    // cage leave its other cells, and every cage is narrowed through the
+    // combination table
+    struct CageStep
+    {
+        // Cage sums narrow cells faster than units narrow places, so digit
+        // branches only add nodes
+        static const bool BRANCH_ON_DIGITS = false;
+
+        const Cages *cages;
+
+        template <typename State, typename Cell, typename Failure>
+        bool operator()(State &state, Cell *stack, int &top, bool &progress, Failure *failure) const
+        {
+            const CombinationTable &table = combinations();
+            for (int cage = 0; cage < cages->count; cage++)
+            {
+                const uint8_t *cells = cages->cells[cage];
+                int size = cages->size[cage];
+
+                // Placed digits, which must differ and leave the open cells
+                int open = 0;
+                int left = cages->sum[cage];
+                unsigned used = 0;
+                for (int i = 0; i < size; i++)
+                {
+                    if (state.placed[cells[i]])
+                    {
+                        unsigned bit = state.candidates[cells[i]];
+                        if (used & bit)
+                        {
+                            return fail(failure, SolveResult::EMPTY_CELL, cells[i], 0);
+                        }
+                        used |= bit;
+                        left -= lowestBit(bit) + 1;
+                    }
+                    else
+                    {
+                        open++;
+                    }
+                }
+                if (open == 0)
+                {
+                    if (left != 0)
+                    {
+                        return fail(failure, SolveResult::EMPTY_CELL, cells[0], 0);
+                    }
+                    continue;
+                }
+
+                unsigned allowed = 0;
+                for (int i = 0; i < size; i++)
+                {
+                    int cell = cells[i];
+                    if (!state.placed[cell] && !narrow(state, cell, ~used, stack, top, progress, failure))
+                    {
+                        return false;
+                    }
+                    allowed |= state.placed[cell] ? 0 : state.candidates[cell];
+                }
+                unsigned any = left > 0 && left <= 45 ? table.any[open][left][allowed] : 0;
+                if (any == 0)
+                {
+                    return fail(failure, SolveResult::EMPTY_CELL, cells[0], 0);
+                }
+                for (int i = 0; i < size; i++)
+                {
+                    if (!state.placed[cells[i]] && !narrow(state, cells[i], any, stack, top, progress, failure))
+                    {
+                        return false;
+                    }
+                }
+
+                // A digit every combination uses, with one open cell left to take it
+                for (unsigned digits = table.all[open][left][allowed]; digits; digits &= digits - 1)
+                {
+                    unsigned bit = digits & (0u - digits);
+                    int place = -1;
+                    int places = 0;
+                    for (int i = 0; i < size; i++)
+                    {
+                        if (!state.placed[cells[i]] && (state.candidates[cells[i]] & bit))
+                        {
+                            place = cells[i];
+                            places++;
+                        }
+                    }
+                    if (places == 0)
+                    {
+                        return fail(failure, SolveResult::MISSING_DIGIT, -1, lowestBit(bit) + 1);
+                    }
+                    if (places == 1 && !narrow(state, place, bit, stack, top, progress, failure))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        // Keep only the candidates of cell in keep; false if none is left
+        template <typename State, typename Cell, typename Failure>
+        static bool narrow(State &state, int cell, unsigned keep, Cell *stack, int &top, bool &progress,
+                           Failure *failure)
+        {
+            unsigned narrowed = state.candidates[cell] & keep;
+            if (narrowed == state.candidates[cell])
+            {
+                return true;
+            }
+            progress = true;
+            state.candidates[cell] = static_cast<uint16_t>(narrowed);
+            if (narrowed == 0)
+            {
+                return fail(failure, SolveResult::EMPTY_CELL, cell, 0);
+            }
+            if ((narrowed & (narrowed - 1)) == 0)
+            {
+                stack[top++] = static_cast<Cell>(cell);
+            }
+            return true;
+        }
+    };
+
+    using CageSolver = SudokuGridSolver<Geometry9, CageStep>;
+
+    SudokuGrid<Geometry9> givensGrid(const SudokuKiller &puzzle)
+    {
+        SudokuGrid<Geometry9> grid;
+        const SudokuBoard &givens = puzzle.getGivens();
+        for (int cell = 0; cell < 81; cell++)
+        {
+            grid.data()[cell] = static_cast<uint8_t>(givens.getValue(rowOf(cell), colOf(cell)));
+        }
+        return grid;
+    }
+
+    // Duplicate givens in a unit or cage, or a cage its givens already overfill
+    bool givensClash(const SudokuKiller &puzzle)
+    {
+        const SudokuBoard &givens = puzzle.getGivens();
+        for (int unit = 0; unit < 27; unit++)
+        {
+            unsigned seen = 0;
+            for (int cell : UNITS[unit])
+            {
+                int value = givens.getValue(rowOf(cell), colOf(cell));
+                unsigned bit = value >= 1 && value <= 9 ? 1u << (value - 1) : 0;
+                if (seen & bit)
+                {
+                    return true;
+                }
+                seen |= bit;
+            }
+        }
+        return puzzle.firstBrokenCage(givens) != SudokuKiller::NO_CAGE;
+    }
+}
+
+unsigned SudokuKillerSolver::combinationDigits(int size, int sum, unsigned allowed)
+{
+    if (size < 0 || size > 9 || sum < 0 || sum > 45)
+    {
+        return 0;
+    }
+    return combinations().any[size][sum][allowed & ALL_DIGITS];
+}
+
+unsigned SudokuKillerSolver::requiredDigits(int size, int sum, unsigned allowed)
+{
+    if (size < 0 || size > 9 || sum < 0 || sum > 45)
+    {
+        return 0;
+    }
+    return combinations().all[size][sum][allowed & ALL_DIGITS];
+}
+
+SolveResult SudokuKillerSolver::solve(const SudokuKiller &puzzle, SudokuBoard &solution,
+                                      const std::atomic<bool> *cancel, SolverStats *stats)
+{
+    if (givensClash(puzzle))
+    {
+        return SolveResult::DUPLICATE_GIVEN;
+    }
+
+    Cages cages;
+    loadCages(puzzle, cages);
+    SudokuGrid<Geometry9> grid = givensGrid(puzzle);
+    Contradiction contradiction;
+    SolveResult result = CageSolver::solve(grid, contradiction, cancel, stats, CageStep{&cages});
+    if (result != SolveResult::SOLVED)
+    {
+        return result;
+    }
+
+    auto &rows = solution.getBoard();
+    for (int cell = 0; cell < 81; cell++)
+    {
+        rows[rowOf(cell)][colOf(cell)] = grid.data()[cell];
+    }
+    return SolveResult::SOLVED;
+}
+
+int SudokuKillerSolver::countSolutions(const SudokuKiller &puzzle, int maxSolutions, SolverStats *stats)
+{
+    if (maxSolutions <= 0 || givensClash(puzzle))
+    {
+        return 0;
+    }
+    Cages cages;
+    loadCages(puzzle, cages);
+    return CageSolver::countSolutions(givensGrid(puzzle), maxSolutions, stats, CageStep{&cages});
+}
+
+bool SudokuKillerSolver::findOtherSolution(const SudokuKiller &puzzle, const uint8_t *known, uint8_t *other,
+                                           SolverStats *stats)
+{
+    if (givensClash(puzzle))
+    {
+        return false;
+    }
+    Cages cages;
+    loadCages(puzzle, cages);
+    return CageSolver::findOtherSolution(givensGrid(puzzle), known, other, stats, CageStep{&cages});
+}
@@ -0,0 +1,208 @@
+#include "SudokuLineReader.hpp"
+#include "SudokuBits.hpp"
+#include <cstring>
+
+#ifdef SUDOKU_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    bool isSeparator(char ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == ',' || ch == ';' || ch == ':' || ch == '|' || ch == '#';
+    }
+
+#ifdef SUDOKU_HAS_SSE2
+    // Convert 16 characters to digits; returns false if any is not 0-9 or '.'
+    inline bool convertBlock(const char *text, uint8_t *cells)
+    {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text));
+        const __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+        const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+        const __m128i isDot = _mm_cmpeq_epi8(chars, _mm_set1_epi8('.'));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(cells), _mm_and_si128(digits, isDigit));
+        return _mm_movemask_epi8(_mm_or_si128(isDigit, isDot)) == 0xFFFF;
+    }
+#endif
+}
+
+SudokuLineReader::SudokuLineReader()
+    : stream(nullptr), cursor(nullptr), limit(nullptr), streamDone(true), currentLine(0), badLines(0) {}
+
+bool SudokuLineReader::open(const std::string &filename)
+{
+    close();
+    if (!mapped.open(filename))
+    {
+        return false;
+    }
+
+    cursor = reinterpret_cast<const char *>(mapped.data());
+    limit = cursor + mapped.size();
+    return true;
+}
+
+bool SudokuLineReader::open(std::FILE *input)
+{
+    close();
+    if (input == nullptr)
+    {
+        return false;
+    }
+
+    stream = input;
+    streamDone = false;
+    buffer.resize(BUFFER_SIZE);
+    cursor = buffer.data();
+    limit = cursor;
+    return true;
+}
+
+void SudokuLineReader::close()
+{
+    mapped.close();
+    stream = nullptr;
+    streamDone = true;
+    cursor = nullptr;
+    limit = nullptr;
+    currentLine = 0;
+    badLines = 0;
+}
+
+bool SudokuLineReader::refill()
+{
+    if (streamDone)
+    {
+        return false;
+    }
+
+    // Slide the unread tail to the front and top the buffer up
+    size_t kept = static_cast<size_t>(limit - cursor);
+    std::memmove(buffer.data(), cursor, kept);
+    size_t bytes = std::fread(buffer.data() + kept, 1, buffer.size() - kept, stream);
+    if (bytes == 0)
+    {
+        streamDone = true;
+    }
+
+    cursor = buffer.data();
+    limit = cursor + kept + bytes;
+    return bytes > 0;
+}
+
+bool SudokuLineReader::nextLine(const char *&line, size_t &length)
+{
+    while (true)
+    {
+        if (cursor == limit && !refill())
+        {
+            return false;
+        }
+
+        const char *newline = static_cast<const char *>(std::memchr(cursor, '\n', limit - cursor));
+        if (newline == nullptr && !streamDone)
+        {
+            if (cursor == buffer.data() && limit == cursor + buffer.size())
+            {
+                // Line longer than the whole buffer: drop it
+                cursor = limit;
+                badLines++;
+                continue;
+            }
+            refill();
+            continue;
+        }
+
+        const char *end = newline != nullptr ? newline : limit;
+        line = cursor;
+        length = static_cast<size_t>(end - cursor);
+        if (length > 0 && line[length - 1] == '\r')
+        {
+            length--;
+        }
+
+        cursor = newline != nullptr ? newline + 1 : limit;
+        currentLine++;
+        return true;
+    }
+}
+
+bool SudokuLineReader::parseLine(const char *line, size_t length, uint8_t *cells)
+{
+    if (length < 81 || (length > 81 && !isSeparator(line[81])))
+    {
+        return false;
+    }
+
+#ifdef SUDOKU_HAS_SSE2
+    // Five aligned-size blocks cover 0-79, a sixth overlapping block covers 65-80
+    uint8_t digits[96];
+    bool valid = convertBlock(line, digits) &
+                 convertBlock(line + 16, digits + 16) &
+                 convertBlock(line + 32, digits + 32) &
+                 convertBlock(line + 48, digits + 48) &
+                 convertBlock(line + 64, digits + 64) &
+                 convertBlock(line + 65, digits + 65);
+    std::memcpy(cells, digits, 81);
+    return valid;
+#else
+    for (int i = 0; i < 81; i++)
+    {
+        char ch = line[i];
+        if (ch == '.')
+        {
+            cells[i] = 0;
+        }
+        else if (ch >= '0' && ch <= '9')
+        {
+            cells[i] = static_cast<uint8_t>(ch - '0');
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+bool SudokuLineReader::next(uint8_t *cells)
+{
+    const char *line;
+    size_t length;
+    while (nextLine(line, length))
+    {
+        if (length == 0 || line[0] == '#')
+        {
+            continue;
+        }
+        if (parseLine(line, length, cells))
+        {
+            return true;
+        }
+        badLines++;
+    }
+    return false;
+}
+
+bool SudokuLineReader::next(SudokuBoard &board)
+{
+    uint8_t cells[81];
+    if (!next(cells))
+    {
+        return false;
+    }
+
+    auto &rows = board.getBoard();
+    for (int i = 0; i < 9; i++)
+    {
+        int *row = rows[i].data();
+        for (int j = 0; j < 9; j++)
+        {
+            row[j] = cells[i * 9 + j];
+        }
+    }
+    return true;
+}
@@ -0,0 +1,143 @@
+#include "SudokuMappedFile.hpp"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+SudokuMappedFile::SudokuMappedFile()
+    : mappedData(nullptr), mappedSize(0), opened(false), fileHandle(nullptr), mappingHandle(nullptr) {}
+#else
+SudokuMappedFile::SudokuMappedFile()
+    : mappedData(nullptr), mappedSize(0), opened(false), fileDescriptor(-1) {}
+#endif
+
+SudokuMappedFile::~SudokuMappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+bool SudokuMappedFile::open(const std::string &filename)
+{
+    close();
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+    opened = true;
+    if (mappedSize == 0)
+    {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+
+    mappedData = static_cast<const unsigned char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (mappedData == nullptr)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SudokuMappedFile::close()
+{
+    if (mappedData != nullptr)
+    {
+        UnmapViewOfFile(mappedData);
+    }
+    if (mappingHandle != nullptr)
+    {
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+    }
+    if (fileHandle != nullptr)
+    {
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+    }
+    mappedData = nullptr;
+    mappedSize = 0;
+    opened = false;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+#else
+bool SudokuMappedFile::open(const std::string &filename)
+{
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    fileDescriptor = fd;
+    mappedSize = static_cast<size_t>(info.st_size);
+    opened = true;
+    if (mappedSize == 0)
+    {
+        return true;
+    }
+
+    void *address = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED)
+    {
+        close();
+        return false;
+    }
+    mappedData = static_cast<const unsigned char *>(address);
+    return true;
+}
+
+void SudokuMappedFile::close()
+{
+    if (mappedData != nullptr)
+    {
+        munmap(const_cast<unsigned char *>(mappedData), mappedSize);
+    }
+    if (fileDescriptor >= 0)
+    {
+        ::close(fileDescriptor);
+    }
+    mappedData = nullptr;
+    mappedSize = 0;
+    opened = false;
+    fileDescriptor = -1;
+}
+#endif
@@ -0,0 +1,271 @@
+#include "SudokuPipeline.hpp"
+#include "SudokuRingBuffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Batch
+    {
+        uint64_t sequence = 0;
+        int count = 0;
+        std::vector<uint8_t> cells; // count * 81 digits
+        std::vector<char> results;  // count * MAX_RESULT_LENGTH bytes
+        std::vector<int> lengths;   // Result length per puzzle
+    };
+
+    double secondsBetween(Clock::time_point start, Clock::time_point end)
+    {
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    // Back off progressively while a queue is empty or full
+    void pause(int &spins)
+    {
+        spins++;
+        if (spins < 64)
+        {
+            return;
+        }
+        if (spins < 1024)
+        {
+            std::this_thread::yield();
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    // Retry operation until it succeeds or giveUp() holds; waiting time is added
+    // to waitSeconds. Returns whether the operation succeeded.
+    template <typename Operation, typename GiveUp>
+    bool waitFor(Operation operation, GiveUp giveUp, double &waitSeconds)
+    {
+        if (operation())
+        {
+            return true;
+        }
+
+        Clock::time_point start = Clock::now();
+        bool done = false;
+        for (int spins = 0; !done; pause(spins))
+        {
+            if (operation())
+            {
+                done = true;
+                break;
+            }
+            if (giveUp())
+            {
+                // Recheck once: the queue may have been filled just before giving up
+                done = operation();
+                break;
+            }
+        }
+        waitSeconds += secondsBetween(start, Clock::now());
+        return done;
+    }
+
+    const char *limitingStage(const PipelineStats &stats)
+    {
+        double reader = stats.reader.utilization();
+        double solvers = stats.solvers.utilization();
+        double writer = stats.writer.utilization();
+        if (solvers >= reader && solvers >= writer)
+        {
+            return "CPU-bound (solvers)";
+        }
+        return reader >= writer ? "I/O-bound (reader)" : "I/O-bound (writer)";
+    }
+}
+
+std::string PipelineStats::summary() const
+{
+    char text[200];
+    std::snprintf(text, sizeof(text), "utilization: reader %.0f%%, %d solvers %.0f%%, writer %.0f%% -> %s",
+                  reader.utilization() * 100, workers, solvers.utilization() * 100,
+                  writer.utilization() * 100, limitingStage(*this));
+    return text;
+}
+
+SudokuPipeline::BatchHandler SudokuPipeline::forEachPuzzle(const Handler &handler)
+{
+    return [handler](const uint8_t *cells, int count, char *results, int *lengths)
+    {
+        SudokuBoard board;
+        char line[81];
+        auto &rows = board.getBoard();
+        for (int i = 0; i < count; i++)
+        {
+            const uint8_t *puzzle = cells + i * 81;
+            for (int k = 0; k < 81; k++)
+            {
+                rows[k / 9][k % 9] = puzzle[k];
+                line[k] = puzzle[k] == 0 ? '.' : static_cast<char>('0' + puzzle[k]);
+            }
+            lengths[i] = handler(board, line, results + i * MAX_RESULT_LENGTH);
+        }
+    };
+}
+
+bool SudokuPipeline::run(SudokuLineReader &reader, std::FILE *out, const Handler &handler,
+                         const PipelineOptions &options, PipelineStats &stats)
+{
+    return run(reader, out, forEachPuzzle(handler), options, stats);
+}
+
+bool SudokuPipeline::run(SudokuLineReader &reader, std::FILE *out, const BatchHandler &handler,
+                         const PipelineOptions &options, PipelineStats &stats)
+{
+    int workerCount = options.workers > 0 ? options.workers : static_cast<int>(std::thread::hardware_concurrency());
+    if (workerCount <= 0)
+    {
+        workerCount = 1;
+    }
+    int batchSize = options.batchSize > 0 ? options.batchSize : 256;
+    int batchCount = workerCount * (options.batchesPerWorker > 0 ? options.batchesPerWorker : 4) + 2;
+
+    // Every batch is allocated here and recycled; nothing grows with the input
+    std::vector<Batch> batches(batchCount);
+    SudokuRingBuffer<Batch *> freeBatches(batchCount);
+    SudokuRingBuffer<Batch *> pending(batchCount);
+    SudokuRingBuffer<Batch *> finished(batchCount);
+    for (Batch &batch : batches)
+    {
+        batch.cells.resize(static_cast<size_t>(batchSize) * 81);
+        batch.results.resize(static_cast<size_t>(batchSize) * MAX_RESULT_LENGTH);
+        batch.lengths.resize(batchSize);
+        freeBatches.tryPush(&batch);
+    }
+
+    std::atomic<bool> readerDone(false);
+    std::atomic<uint64_t> batchesRead(0);
+    std::atomic<int> workersDone(0);
+    std::vector<StageStats> workerStats(workerCount);
+    bool writeOk = true;
+    auto never = []() { return false; };
+
+    Clock::time_point start = Clock::now();
+
+    std::thread readerThread([&]()
+    {
+        Clock::time_point begin = Clock::now();
+        uint64_t sequence = 0;
+        bool more = true;
+        while (more)
+        {
+            Batch *batch = nullptr;
+            waitFor([&]() { return freeBatches.tryPop(batch); }, never, stats.reader.waitSeconds);
+
+            batch->sequence = sequence++;
+            batch->count = 0;
+            while (batch->count < batchSize && (more = reader.next(&batch->cells[batch->count * 81])))
+            {
+                batch->count++;
+            }
+
+            if (batch->count == 0)
+            {
+                sequence--;
+                freeBatches.tryPush(batch);
+                break;
+            }
+            waitFor([&]() { return pending.tryPush(batch); }, never, stats.reader.waitSeconds);
+        }
+        batchesRead.store(sequence);
+        readerDone.store(true);
+        stats.reader.busySeconds = secondsBetween(begin, Clock::now()) - stats.reader.waitSeconds;
+    });
+
+    auto worker = [&](int id)
+    {
+        StageStats &own = workerStats[id];
+        Clock::time_point begin = Clock::now();
+
+        while (true)
+        {
+            Batch *batch = nullptr;
+            if (!waitFor([&]() { return pending.tryPop(batch); }, [&]() { return readerDone.load(); }, own.waitSeconds))
+            {
+                break;
+            }
+
+            handler(batch->cells.data(), batch->count, batch->results.data(), batch->lengths.data());
+            waitFor([&]() { return finished.tryPush(batch); }, never, own.waitSeconds);
+        }
+
+        own.busySeconds = secondsBetween(begin, Clock::now()) - own.waitSeconds;
+        workersDone++;
+    };
+
+    std::thread writerThread([&]()
+    {
+        Clock::time_point begin = Clock::now();
+
+        // Batches finish out of order; park them by sequence until their turn
+        std::vector<Batch *> parked(batchCount, nullptr);
+        uint64_t next = 0;
+        auto allWritten = [&]()
+        {
+            return readerDone.load() && workersDone.load() == workerCount && next == batchesRead.load();
+        };
+
+        while (true)
+        {
+            Batch *batch = nullptr;
+            if (!waitFor([&]() { return finished.tryPop(batch); }, allWritten, stats.writer.waitSeconds))
+            {
+                if (allWritten())
+                {
+                    break;
+                }
+                continue;
+            }
+
+            parked[batch->sequence % batchCount] = batch;
+            while (parked[next % batchCount] != nullptr && parked[next % batchCount]->sequence == next)
+            {
+                Batch *ready = parked[next % batchCount];
+                parked[next % batchCount] = nullptr;
+                for (int i = 0; i < ready->count; i++)
+                {
+                    char *result = &ready->results[i * MAX_RESULT_LENGTH];
+                    writeOk &= std::fwrite(result, 1, ready->lengths[i], out) == static_cast<size_t>(ready->lengths[i]);
+                    writeOk &= std::fputc('\n', out) != EOF;
+                }
+                stats.puzzles += ready->count;
+                next++;
+                freeBatches.tryPush(ready);
+            }
+        }
+
+        writeOk &= std::fflush(out) == 0;
+        stats.writer.busySeconds = secondsBetween(begin, Clock::now()) - stats.writer.waitSeconds;
+    });
+
+    std::vector<std::thread> workers;
+    for (int id = 0; id < workerCount; id++)
+    {
+        workers.emplace_back(worker, id);
+    }
+    for (auto &thread : workers)
+    {
+        thread.join();
+    }
+    readerThread.join();
+    writerThread.join();
+
+    stats.workers = workerCount;
+    for (const StageStats &own : workerStats)
+    {
+        stats.solvers.busySeconds += own.busySeconds;
+        stats.solvers.waitSeconds += own.waitSeconds;
+    }
+    stats.invalidLines = reader.invalidLines();
+    stats.seconds = secondsBetween(start, Clock::now());
+    return writeOk;
+}
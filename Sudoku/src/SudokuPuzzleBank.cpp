@@ -0,0 +1,238 @@
+#include "SudokuPuzzleBank.hpp"
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    const char BANK_MAGIC[8] = {'S', 'D', 'K', 'B', 'A', 'N', 'K', '1'};
+    const uint32_t BANK_VERSION = 1;
+
+    struct BankHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t totalCount;
+        uint64_t firstRecord[SudokuPuzzleBank::DIFFICULTY_COUNT];
+        uint64_t recordCount[SudokuPuzzleBank::DIFFICULTY_COUNT];
+    };
+
+    static_assert(sizeof(BankHeader) <= SudokuPuzzleBank::HEADER_SIZE, "bank header does not fit");
+}
+
+SudokuPuzzleBank::SudokuPuzzleBank() : records(nullptr), totalCount(0), firstRecord{}, recordCount{} {}
+
+bool SudokuPuzzleBank::open(const std::string &filename)
+{
+    close();
+    if (!file.open(filename) || file.size() < static_cast<size_t>(HEADER_SIZE))
+    {
+        close();
+        return false;
+    }
+
+    BankHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    // Counts are checked against what the file can hold before any product or sum,
+    // so a crafted header cannot wrap around into a passing size check
+    uint64_t capacity = (file.size() - HEADER_SIZE) / RECORD_SIZE;
+    bool valid = std::memcmp(header.magic, BANK_MAGIC, sizeof(BANK_MAGIC)) == 0 &&
+                 header.version == BANK_VERSION &&
+                 header.recordSize == RECORD_SIZE &&
+                 header.totalCount <= capacity &&
+                 file.size() == HEADER_SIZE + header.totalCount * RECORD_SIZE;
+
+    // Difficulty ranges must tile the record area in enum order
+    uint64_t expectedFirst = 0;
+    for (int i = 0; valid && i < DIFFICULTY_COUNT; i++)
+    {
+        valid = header.firstRecord[i] == expectedFirst && header.recordCount[i] <= header.totalCount - expectedFirst;
+        expectedFirst += header.recordCount[i];
+    }
+    if (!valid || expectedFirst != header.totalCount)
+    {
+        close();
+        return false;
+    }
+
+    records = file.data() + HEADER_SIZE;
+    totalCount = header.totalCount;
+    for (int i = 0; i < DIFFICULTY_COUNT; i++)
+    {
+        firstRecord[i] = header.firstRecord[i];
+        recordCount[i] = header.recordCount[i];
+    }
+    return true;
+}
+
+void SudokuPuzzleBank::close()
+{
+    file.close();
+    records = nullptr;
+    totalCount = 0;
+    for (int i = 0; i < DIFFICULTY_COUNT; i++)
+    {
+        firstRecord[i] = 0;
+        recordCount[i] = 0;
+    }
+}
+
+uint64_t SudokuPuzzleBank::count(Difficulty difficulty) const
+{
+    return recordCount[static_cast<int>(difficulty)];
+}
+
+const unsigned char *SudokuPuzzleBank::record(Difficulty difficulty, uint64_t index) const
+{
+    int group = static_cast<int>(difficulty);
+    if (index >= recordCount[group])
+    {
+        return nullptr;
+    }
+    return records + (firstRecord[group] + index) * RECORD_SIZE;
+}
+
+bool SudokuPuzzleBank::getPuzzle(Difficulty difficulty, uint64_t index, SudokuBoard &puzzle,
+                                 SudokuBoard *solution, int *rating) const
+{
+    const unsigned char *entry = record(difficulty, index);
+    if (entry == nullptr)
+    {
+        return false;
+    }
+
+    puzzle.decodePacked(entry);
+    if (solution != nullptr)
+    {
+        solution->decodePacked(entry + SudokuBoard::PACKED_SIZE);
+    }
+    if (rating != nullptr)
+    {
+        *rating = entry[2 * SudokuBoard::PACKED_SIZE] | (entry[2 * SudokuBoard::PACKED_SIZE + 1] << 8);
+    }
+    return true;
+}
+
+bool SudokuPuzzleBank::randomPuzzle(Difficulty difficulty, std::mt19937 &random, SudokuBoard &puzzle,
+                                    SudokuBoard *solution, int *rating) const
+{
+    uint64_t available = count(difficulty);
+    if (available == 0)
+    {
+        return false;
+    }
+
+    uint64_t draw = (static_cast<uint64_t>(random()) << 32) | random();
+    return getPuzzle(difficulty, draw % available, puzzle, solution, rating);
+}
+
+SudokuPuzzleBankWriter::SudokuPuzzleBankWriter() : spillFiles{}, spillCounts{} {}
+
+SudokuPuzzleBankWriter::~SudokuPuzzleBankWriter()
+{
+    // An unfinished bank leaves nothing behind
+    for (int i = 0; i < SudokuPuzzleBank::DIFFICULTY_COUNT; i++)
+    {
+        if (spillFiles[i] != nullptr)
+        {
+            std::fclose(spillFiles[i]);
+            std::remove(spillName(i).c_str());
+        }
+    }
+}
+
+std::string SudokuPuzzleBankWriter::spillName(int difficulty) const
+{
+    return bankFilename + ".part" + std::to_string(difficulty);
+}
+
+bool SudokuPuzzleBankWriter::open(const std::string &filename)
+{
+    bankFilename = filename;
+    for (int i = 0; i < SudokuPuzzleBank::DIFFICULTY_COUNT; i++)
+    {
+        if (spillFiles[i] != nullptr)
+        {
+            std::fclose(spillFiles[i]);
+        }
+        spillCounts[i] = 0;
+        spillFiles[i] = std::fopen(spillName(i).c_str(), "w+b");
+        if (spillFiles[i] == nullptr)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SudokuPuzzleBankWriter::add(const SudokuBoard &puzzle, const SudokuBoard &solution, int rating,
+                                 Difficulty difficulty)
+{
+    std::FILE *spill = spillFiles[static_cast<int>(difficulty)];
+    if (spill == nullptr)
+    {
+        return false;
+    }
+
+    unsigned char entry[SudokuPuzzleBank::RECORD_SIZE];
+    puzzle.encodePacked(entry);
+    solution.encodePacked(entry + SudokuBoard::PACKED_SIZE);
+    entry[2 * SudokuBoard::PACKED_SIZE] = static_cast<unsigned char>(rating & 0xFF);
+    entry[2 * SudokuBoard::PACKED_SIZE + 1] = static_cast<unsigned char>((rating >> 8) & 0xFF);
+
+    if (std::fwrite(entry, sizeof(entry), 1, spill) != 1)
+    {
+        return false;
+    }
+    spillCounts[static_cast<int>(difficulty)]++;
+    return true;
+}
+
+bool SudokuPuzzleBankWriter::finish()
+{
+    if (spillFiles[0] == nullptr)
+    {
+        return false; // Not opened
+    }
+
+    std::FILE *bank = std::fopen(bankFilename.c_str(), "wb");
+    if (bank == nullptr)
+    {
+        return false;
+    }
+
+    BankHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BANK_MAGIC, sizeof(BANK_MAGIC));
+    header.version = BANK_VERSION;
+    header.recordSize = SudokuPuzzleBank::RECORD_SIZE;
+    for (int i = 0; i < SudokuPuzzleBank::DIFFICULTY_COUNT; i++)
+    {
+        header.firstRecord[i] = header.totalCount;
+        header.recordCount[i] = spillCounts[i];
+        header.totalCount += spillCounts[i];
+    }
+
+    unsigned char headerBytes[SudokuPuzzleBank::HEADER_SIZE] = {0};
+    std::memcpy(headerBytes, &header, sizeof(header));
+    bool ok = std::fwrite(headerBytes, sizeof(headerBytes), 1, bank) == 1;
+
+    // Append the spill files in difficulty order
+    std::vector<unsigned char> buffer(1 << 16);
+    for (int i = 0; i < SudokuPuzzleBank::DIFFICULTY_COUNT && ok; i++)
+    {
+        std::rewind(spillFiles[i]);
+        size_t bytes;
+        while (ok && (bytes = std::fread(buffer.data(), 1, buffer.size(), spillFiles[i])) > 0)
+        {
+            ok = std::fwrite(buffer.data(), 1, bytes, bank) == bytes;
+        }
+        std::fclose(spillFiles[i]);
+        spillFiles[i] = nullptr;
+        std::remove(spillName(i).c_str());
+    }
+
+    ok = std::fclose(bank) == 0 && ok;
+    return ok;
+}
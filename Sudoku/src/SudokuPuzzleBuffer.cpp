@@ -0,0 +1,107 @@
+#include "SudokuPuzzleBuffer.hpp"
+#include <chrono>
+
+SudokuPuzzleBuffer::SudokuPuzzleBuffer(int capacity, const SudokuPuzzleBank *bank)
+    : capacity(capacity), stopping(false), bank(bank)
+{
+    if (capacity > 0)
+    {
+        refiller = std::thread(&SudokuPuzzleBuffer::refill, this);
+    }
+}
+
+SudokuPuzzleBuffer::~SudokuPuzzleBuffer()
+{
+    {
+        std::lock_guard<std::mutex> lock(stockMutex);
+        stopping = true;
+    }
+    stockTaken.notify_all();
+    if (refiller.joinable())
+    {
+        refiller.join();
+    }
+}
+
+bool SudokuPuzzleBuffer::take(Difficulty difficulty, uint8_t *cells)
+{
+    Packed packed;
+    {
+        std::lock_guard<std::mutex> lock(stockMutex);
+        auto &queue = stock[static_cast<int>(difficulty)];
+        if (queue.empty())
+        {
+            return false;
+        }
+        packed = queue.front();
+        queue.pop_front();
+    }
+    stockTaken.notify_one();
+    SudokuBoard::unpackCells(packed.data(), cells);
+    return true;
+}
+
+void SudokuPuzzleBuffer::generate(Difficulty difficulty, uint8_t *cells, std::mt19937 &random)
+{
+    SudokuBoard board;
+    if (bank != nullptr && bank->count(difficulty) > 0)
+    {
+        bank->randomPuzzle(difficulty, random, board);
+    }
+    else
+    {
+        board = SudokuGenerator::generatePuzzle(difficulty, random);
+    }
+    for (int cell = 0; cell < 81; cell++)
+    {
+        cells[cell] = static_cast<uint8_t>(board.getValue(cell / 9, cell % 9));
+    }
+}
+
+size_t SudokuPuzzleBuffer::available(Difficulty difficulty)
+{
+    std::lock_guard<std::mutex> lock(stockMutex);
+    return stock[static_cast<int>(difficulty)].size();
+}
+
+void SudokuPuzzleBuffer::refill()
+{
+    std::mt19937 random(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    for (;;)
+    {
+        // Top up the emptiest stock first so no difficulty starves
+        int target = -1;
+        {
+            std::unique_lock<std::mutex> lock(stockMutex);
+            stockTaken.wait(lock, [this, &target]
+            {
+                if (stopping)
+                {
+                    return true;
+                }
+                size_t lowest = static_cast<size_t>(capacity);
+                for (int d = 0; d < DIFFICULTY_COUNT; d++)
+                {
+                    if (stock[d].size() < lowest)
+                    {
+                        lowest = stock[d].size();
+                        target = d;
+                    }
+                }
+                return target >= 0;
+            });
+            if (stopping)
+            {
+                return;
+            }
+        }
+
+        uint8_t cells[81];
+        generate(static_cast<Difficulty>(target), cells, random);
+
+        Packed packed;
+        SudokuBoard::packCells(cells, packed.data());
+        std::lock_guard<std::mutex> lock(stockMutex);
+        stock[target].push_back(packed);
+    }
+}
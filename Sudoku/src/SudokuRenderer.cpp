@@ -0,0 +1,179 @@
+#include "SudokuRenderer.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char RULE[] = "-------------------------------------\n";
+    const size_t RULE_SIZE = sizeof(RULE) - 1;
+
+    // The text below the board scrolls from this screen line down
+    const int DIALOG_LINE = SudokuRenderer::FRAME_LINES + 1;
+
+    char digitChar(int value)
+    {
+        return value >= 1 && value <= 9 ? static_cast<char>('0' + value) : '.';
+    }
+
+    // Screen position (1-based) of a cell inside a frame drawn from the top-left corner
+    int screenRow(int row)
+    {
+        return 2 + row + row / 3;
+    }
+
+    int screenColumn(int col)
+    {
+        return 1 + 2 * col + 2 * (col / 3);
+    }
+
+    size_t append(char *out, size_t length, const char *text)
+    {
+        size_t size = std::strlen(text);
+        std::memcpy(out + length, text, size);
+        return length + size;
+    }
+}
+
+SudokuRenderer::SudokuRenderer(RenderMode mode) : mode(mode), drawn(false)
+{
+    std::memset(shown, 0, sizeof(shown));
+}
+
+SudokuRenderer::~SudokuRenderer()
+{
+    if (mode == RenderMode::ANSI && drawn)
+    {
+        // Save the cursor, drop the scroll region, restore the cursor
+        flush(append(buffer, 0, "\0337\033[r\0338"));
+    }
+}
+
+RenderMode SudokuRenderer::detectMode()
+{
+#ifdef _WIN32
+    return RenderMode::PLAIN;
+#else
+    const char *term = std::getenv("TERM");
+    if (!isatty(STDOUT_FILENO) || term == nullptr || std::strcmp(term, "dumb") == 0)
+    {
+        return RenderMode::PLAIN;
+    }
+    return RenderMode::ANSI;
+#endif
+}
+
+void SudokuRenderer::formatFrame(const SudokuBoard &board, char *frame)
+{
+    const auto &rows = board.getBoard();
+    char *out = frame;
+
+    std::memcpy(out, RULE, RULE_SIZE);
+    out += RULE_SIZE;
+    for (int i = 0; i < 9; i++)
+    {
+        for (int j = 0; j < 9; j++)
+        {
+            *out++ = digitChar(rows[i][j]);
+            *out++ = ' ';
+            if (j == 2 || j == 5)
+            {
+                *out++ = '|';
+                *out++ = ' ';
+            }
+        }
+        *out++ = '\n';
+
+        if (i % 3 == 2)
+        {
+            std::memcpy(out, RULE, RULE_SIZE);
+            out += RULE_SIZE;
+        }
+    }
+}
+
+void SudokuRenderer::render(const SudokuBoard &board)
+{
+    const auto &rows = board.getBoard();
+
+    if (mode == RenderMode::PLAIN)
+    {
+        formatFrame(board, buffer);
+        flush(FRAME_SIZE);
+        return;
+    }
+
+    size_t length = 0;
+    if (!drawn)
+    {
+        // Reset the scroll region, clear, draw everything, then confine
+        // scrolling to the lines below the board and park the cursor there
+        length = append(buffer, length, "\033[r\033[H\033[2J");
+        formatFrame(board, buffer + length);
+        length += FRAME_SIZE;
+        length += std::snprintf(buffer + length, BUFFER_SIZE - length, "\033[%dr\033[%d;1H", DIALOG_LINE, DIALOG_LINE);
+        for (int cell = 0; cell < 81; cell++)
+        {
+            shown[cell] = static_cast<uint8_t>(rows[cell / 9][cell % 9]);
+        }
+        drawn = true;
+        flush(length);
+        return;
+    }
+
+    length = append(buffer, length, "\0337");
+    size_t changes = length;
+    for (int cell = 0; cell < 81; cell++)
+    {
+        int row = cell / 9;
+        int col = cell % 9;
+        uint8_t value = static_cast<uint8_t>(rows[row][col]);
+        if (value == shown[cell])
+        {
+            continue;
+        }
+        shown[cell] = value;
+        length += std::snprintf(buffer + length, BUFFER_SIZE - length, "\033[%d;%dH%c", screenRow(row),
+                                screenColumn(col), digitChar(value));
+    }
+    if (length == changes)
+    {
+        return; // Nothing to repaint
+    }
+    length = append(buffer, length, "\0338");
+    flush(length);
+}
+
+void SudokuRenderer::flush(size_t length)
+{
+    // Menus and prompts go through std::cout, so they must reach the terminal first
+    std::cout.flush();
+    std::fflush(stdout);
+
+#ifdef _WIN32
+    std::fwrite(buffer, 1, length, stdout);
+    std::fflush(stdout);
+#else
+    const char *data = buffer;
+    while (length > 0)
+    {
+        ssize_t written = ::write(STDOUT_FILENO, data, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+#endif
+}
@@ -0,0 +1,561 @@
+#include "SudokuService.hpp"
+
+#ifdef _WIN32
+
+bool SudokuService::run(const ServiceOptions &, const std::atomic<bool> &, ServiceStats &)
+{
+    return false;
+}
+
+#else
+
+#include "SudokuAdvancedChecks.hpp"
+#include "SudokuBatchSolver.hpp"
+#include "SudokuPuzzleBuffer.hpp"
+#include "SudokuSocket.hpp"
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <poll.h>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    enum class RequestType : uint8_t
+    {
+        SOLVE,
+        RATE,
+        GENERATE
+    };
+
+    struct Request
+    {
+        uint64_t connection;
+        uint64_t sequence;
+        RequestType type;
+        Difficulty difficulty;
+        uint8_t cells[81];
+    };
+
+    struct Reply
+    {
+        uint64_t connection;
+        uint64_t sequence;
+        std::string text;
+    };
+
+    // Requests waiting for a worker and replies waiting for the I/O thread.
+    // Workers sleep on the condition variable; the I/O thread is woken through a
+    // pipe so it can keep waiting in poll().
+    class WorkQueue
+    {
+    public:
+        explicit WorkQueue(int wakeFd) : wakeFd(wakeFd), stopping(false) {}
+
+        void push(std::vector<Request> &requests)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending.insert(pending.end(), requests.begin(), requests.end());
+            }
+            requests.clear();
+            ready.notify_all();
+        }
+
+        // Wait for work and take up to limit requests; false once stopping
+        bool popBatch(std::vector<Request> &batch, size_t limit)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (stopping)
+            {
+                return false;
+            }
+            size_t count = pending.size() < limit ? pending.size() : limit;
+            batch.assign(pending.begin(), pending.begin() + count);
+            pending.erase(pending.begin(), pending.begin() + count);
+            return true;
+        }
+
+        void finish(std::vector<Reply> &replies)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (Reply &reply : replies)
+                {
+                    done.push_back(std::move(reply));
+                }
+            }
+            replies.clear();
+            char byte = 1;
+            ssize_t ignored = ::write(wakeFd, &byte, 1); // A full pipe already means "wake up"
+            (void)ignored;
+        }
+
+        void collect(std::vector<Reply> &replies)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            replies.swap(done);
+        }
+
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            ready.notify_all();
+        }
+
+    private:
+        int wakeFd;
+        bool stopping;
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<Request> pending;
+        std::vector<Reply> done;
+    };
+
+    std::string formatCells(const uint8_t *cells)
+    {
+        std::string text = "OK ";
+        for (int cell = 0; cell < 81; cell++)
+        {
+            text += cells[cell] == 0 ? '.' : static_cast<char>('0' + cells[cell]);
+        }
+        return text;
+    }
+
+    // Worker body: settle batches until the queue stops. Generate requests the
+    // stock cannot cover are generated after the rest of the batch is answered,
+    // so the solves batched with them do not wait for the generator.
+    void work(WorkQueue &queue, SudokuPuzzleBuffer &buffer, size_t batchSize, std::atomic<long long> &batches,
+              std::atomic<long long> &bufferHits)
+    {
+        std::mt19937 random(std::random_device{}());
+        std::vector<Request> batch;
+        std::vector<Reply> replies;
+        std::vector<uint8_t> puzzles;
+        std::vector<uint8_t> solutions;
+        std::vector<BatchResult> results;
+        std::vector<size_t> solveIndex;
+        std::vector<size_t> misses;
+
+        while (queue.popBatch(batch, batchSize))
+        {
+            batches++;
+
+            // Every solve in the batch goes through the lane-parallel solver at once
+            puzzles.clear();
+            solveIndex.clear();
+            for (size_t i = 0; i < batch.size(); i++)
+            {
+                if (batch[i].type == RequestType::SOLVE)
+                {
+                    puzzles.insert(puzzles.end(), batch[i].cells, batch[i].cells + 81);
+                    solveIndex.push_back(i);
+                }
+            }
+            if (!solveIndex.empty())
+            {
+                int count = static_cast<int>(solveIndex.size());
+                solutions.resize(puzzles.size());
+                results.resize(solveIndex.size());
+                SudokuBatchSolver::solve(puzzles.data(), count, solutions.data(), results.data());
+            }
+
+            size_t solved = 0;
+            misses.clear();
+            for (size_t i = 0; i < batch.size(); i++)
+            {
+                Request &request = batch[i];
+                Reply reply{request.connection, request.sequence, std::string()};
+                if (request.type == RequestType::SOLVE)
+                {
+                    bool failed = results[solved] == BatchResult::UNSOLVABLE;
+                    reply.text = failed ? "ERR unsolvable" : formatCells(&solutions[solved * 81]);
+                    solved++;
+                }
+                else if (request.type == RequestType::RATE)
+                {
+                    SudokuBoard board;
+                    auto &rows = board.getBoard();
+                    for (int cell = 0; cell < 81; cell++)
+                    {
+                        rows[cell / 9][cell % 9] = request.cells[cell];
+                    }
+                    PuzzleRating rating = SudokuAdvancedChecks::ratePuzzle(board);
+                    reply.text = rating.consistent ? "OK " + std::to_string(rating.score) + " " +
+                                                         SudokuAdvancedChecks::techniqueName(rating.hardest)
+                                                   : std::string("ERR invalid");
+                }
+                else
+                {
+                    uint8_t cells[81];
+                    if (!buffer.take(request.difficulty, cells))
+                    {
+                        misses.push_back(i);
+                        continue;
+                    }
+                    bufferHits++;
+                    reply.text = formatCells(cells);
+                }
+                replies.push_back(std::move(reply));
+            }
+            queue.finish(replies);
+
+            for (size_t i : misses)
+            {
+                uint8_t cells[81];
+                buffer.generate(batch[i].difficulty, cells, random);
+                replies.push_back(Reply{batch[i].connection, batch[i].sequence, formatCells(cells)});
+                queue.finish(replies);
+            }
+        }
+    }
+
+    // Parse one request line; false if malformed
+    bool parseRequest(const char *line, size_t length, Request &request)
+    {
+        while (length > 0 && (line[length - 1] == '\r' || line[length - 1] == ' '))
+        {
+            length--;
+        }
+
+        const char *space = static_cast<const char *>(std::memchr(line, ' ', length));
+        if (space == nullptr)
+        {
+            return false;
+        }
+        std::string command(line, static_cast<size_t>(space - line));
+        const char *argument = space + 1;
+        size_t argumentLength = length - (command.size() + 1);
+
+        if (command == "GENERATE")
+        {
+            std::string level(argument, argumentLength);
+            request.type = RequestType::GENERATE;
+            if (level == "easy")
+                request.difficulty = Difficulty::EASY;
+            else if (level == "medium")
+                request.difficulty = Difficulty::MEDIUM;
+            else if (level == "hard")
+                request.difficulty = Difficulty::HARD;
+            else
+                return false;
+            return true;
+        }
+
+        if (command == "SOLVE")
+            request.type = RequestType::SOLVE;
+        else if (command == "RATE")
+            request.type = RequestType::RATE;
+        else
+            return false;
+
+        if (argumentLength != 81)
+        {
+            return false;
+        }
+        for (int cell = 0; cell < 81; cell++)
+        {
+            char c = argument[cell];
+            if (c != '.' && (c < '0' || c > '9'))
+            {
+                return false;
+            }
+            request.cells[cell] = c == '.' ? 0 : static_cast<uint8_t>(c - '0');
+        }
+        return true;
+    }
+
+    // Replies are written in request order even when workers finish out of order
+    struct Client
+    {
+        int socket;
+        std::string input;
+        std::string output;
+        uint64_t nextSequence;
+        uint64_t nextToSend;
+        std::map<uint64_t, std::string> finished;
+        bool hungUp;  // Sent EOF: read no more, but answer what it asked
+        bool closing; // Failed: close now
+    };
+
+    void deliver(Client &client, uint64_t sequence, std::string text)
+    {
+        client.finished.emplace(sequence, std::move(text));
+        auto next = client.finished.begin();
+        while (next != client.finished.end() && next->first == client.nextToSend)
+        {
+            client.output += next->second;
+            client.output += '\n';
+            client.nextToSend++;
+            next = client.finished.erase(next);
+        }
+    }
+
+    // Too much is owed to the client to take more requests from it: parsed lines
+    // stay in its input, and unread ones in the socket, until it catches up
+    bool backedUp(const Client &client)
+    {
+        return client.output.size() >= SudokuService::MAX_OUTPUT ||
+               client.nextSequence - client.nextToSend >= SudokuService::MAX_PENDING;
+    }
+
+    // A client that hung up and has had every reply it asked for
+    bool answered(const Client &client)
+    {
+        return client.hungUp && client.input.empty() && client.nextToSend == client.nextSequence &&
+               client.output.empty();
+    }
+
+    // Send what the socket takes now; false if the client is gone
+    bool flushOutput(Client &client)
+    {
+        while (!client.output.empty())
+        {
+            bool wouldBlock;
+            long sent = SudokuSocket::send(client.socket, client.output.data(), client.output.size(), wouldBlock);
+            if (sent < 0)
+            {
+                return wouldBlock;
+            }
+            client.output.erase(0, static_cast<size_t>(sent));
+        }
+        return true;
+    }
+}
+
+bool SudokuService::run(const ServiceOptions &options, const std::atomic<bool> &stop, ServiceStats &stats)
+{
+    std::vector<int> listeners;
+    if (!options.socketPath.empty())
+    {
+        listeners.push_back(SudokuSocket::listenUnix(options.socketPath));
+    }
+    if (options.tcpPort > 0)
+    {
+        listeners.push_back(SudokuSocket::listenTcp(options.tcpPort));
+    }
+    bool listening = !listeners.empty();
+    for (int listener : listeners)
+    {
+        listening = listening && listener >= 0 && SudokuSocket::setNonBlocking(listener);
+    }
+
+    int wake[2];
+    if (!listening || ::pipe(wake) != 0)
+    {
+        for (int listener : listeners)
+        {
+            SudokuSocket::close(listener);
+        }
+        return false;
+    }
+    SudokuSocket::setNonBlocking(wake[0]);
+    SudokuSocket::setNonBlocking(wake[1]);
+
+    SudokuPuzzleBuffer buffer(options.bufferSize, options.bank);
+    WorkQueue queue(wake[1]);
+    std::atomic<long long> batches(0);
+    std::atomic<long long> bufferHits(0);
+
+    int workerCount = options.workers > 0 ? options.workers : static_cast<int>(std::thread::hardware_concurrency());
+    if (workerCount < 1)
+    {
+        workerCount = 1;
+    }
+    size_t batchSize = options.batchSize > 0 ? static_cast<size_t>(options.batchSize) : 1;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < workerCount; i++)
+    {
+        workers.emplace_back(work, std::ref(queue), std::ref(buffer), batchSize, std::ref(batches),
+                             std::ref(bufferHits));
+    }
+
+    std::unordered_map<uint64_t, Client> clients;
+    uint64_t nextConnection = 1;
+    std::vector<pollfd> polls;
+    std::vector<uint64_t> pollOwners;
+    std::vector<Request> requests;
+    std::vector<Reply> replies;
+    char readBuffer[65536];
+
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        // Wake pipe first, then listeners, then clients
+        polls.clear();
+        pollOwners.clear();
+        polls.push_back(pollfd{wake[0], POLLIN, 0});
+        for (int listener : listeners)
+        {
+            polls.push_back(pollfd{listener, POLLIN, 0});
+        }
+        for (auto &entry : clients)
+        {
+            // A client that is not reading its replies is not read from either,
+            // nor one that hung up
+            const Client &client = entry.second;
+            short events = backedUp(client) || client.hungUp ? 0 : POLLIN;
+            if (!client.output.empty())
+            {
+                events |= POLLOUT;
+            }
+            // With nothing to wait for, leave it out (a negative fd), or a hung-up
+            // socket would report POLLHUP on every pass while its replies are made
+            polls.push_back(pollfd{events ? client.socket : -1, events, 0});
+            pollOwners.push_back(entry.first);
+        }
+
+        if (::poll(polls.data(), polls.size(), 200) <= 0)
+        {
+            continue;
+        }
+
+        // Replies from the workers
+        if (polls[0].revents & POLLIN)
+        {
+            while (::read(wake[0], readBuffer, sizeof(readBuffer)) > 0)
+            {
+            }
+            queue.collect(replies);
+            for (Reply &reply : replies)
+            {
+                auto found = clients.find(reply.connection);
+                if (found != clients.end())
+                {
+                    deliver(found->second, reply.sequence, std::move(reply.text));
+                }
+            }
+            replies.clear();
+        }
+
+        // Requests from the clients
+        size_t firstClient = 1 + listeners.size();
+        for (size_t i = firstClient; i < polls.size(); i++)
+        {
+            uint64_t connection = pollOwners[i - firstClient];
+            Client &client = clients[connection];
+            if (polls[i].revents & POLLERR)
+            {
+                client.closing = true;
+            }
+            else if ((polls[i].revents & (POLLIN | POLLHUP)) && !client.hungUp)
+            {
+                bool wouldBlock;
+                long bytes = SudokuSocket::receive(client.socket, readBuffer, sizeof(readBuffer), wouldBlock);
+                if (bytes > 0)
+                {
+                    client.input.append(readBuffer, static_cast<size_t>(bytes));
+                }
+                else if (bytes == 0)
+                {
+                    // EOF ends the input, and with it an unterminated last line
+                    client.hungUp = true;
+                    if (!client.input.empty() && client.input.back() != '\n')
+                    {
+                        client.input += '\n';
+                    }
+                }
+                else if (!wouldBlock)
+                {
+                    client.closing = true;
+                }
+            }
+
+            size_t start = 0;
+            size_t newline;
+            while (!backedUp(client) && (newline = client.input.find('\n', start)) != std::string::npos)
+            {
+                Request request;
+                request.connection = connection;
+                request.sequence = client.nextSequence++;
+                if (parseRequest(client.input.data() + start, newline - start, request))
+                {
+                    requests.push_back(request);
+                }
+                else
+                {
+                    deliver(client, request.sequence, "ERR bad-request");
+                }
+                stats.requests++;
+                start = newline + 1;
+            }
+            client.input.erase(0, start);
+            if (client.input.size() > MAX_LINE && client.input.find('\n') == std::string::npos)
+            {
+                client.closing = true;
+            }
+        }
+        if (!requests.empty())
+        {
+            queue.push(requests);
+        }
+
+        // Write, and drop clients that failed (their outstanding replies are
+        // discarded) or that hung up and have been answered in full
+        for (auto entry = clients.begin(); entry != clients.end();)
+        {
+            Client &client = entry->second;
+            bool alive = flushOutput(client) && !client.closing && !answered(client);
+            if (!alive)
+            {
+                SudokuSocket::close(client.socket);
+                entry = clients.erase(entry);
+            }
+            else
+            {
+                ++entry;
+            }
+        }
+
+        for (size_t i = 1; i < firstClient; i++)
+        {
+            if (!(polls[i].revents & POLLIN))
+            {
+                continue;
+            }
+            int socket;
+            while ((socket = SudokuSocket::accept(polls[i].fd)) >= 0)
+            {
+                SudokuSocket::setNonBlocking(socket);
+                SudokuSocket::setNoDelay(socket);
+                clients.emplace(nextConnection++, Client{socket, std::string(), std::string(), 0, 0, {}, false, false});
+                stats.connections++;
+            }
+        }
+    }
+
+    queue.stop();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    for (auto &entry : clients)
+    {
+        SudokuSocket::close(entry.second.socket);
+    }
+    for (int listener : listeners)
+    {
+        SudokuSocket::close(listener);
+    }
+    if (!options.socketPath.empty())
+    {
+        SudokuSocket::unlinkPath(options.socketPath);
+    }
+    ::close(wake[0]);
+    ::close(wake[1]);
+
+    stats.batches = batches.load();
+    stats.bufferHits = bufferHits.load();
+    return true;
+}
+
+#endif
@@ -0,0 +1,531 @@
+#include "SudokuSessionManager.hpp"
+#include "SudokuBits.hpp"
+#include "SudokuGenerator.hpp"
+#include "SudokuPuzzleBuffer.hpp"
+#include "SudokuSolver.hpp"
+#include <cstdio>
+#include <cstring>
+
+using namespace SudokuBits;
+
+namespace
+{
+    const uint8_t IN_USE = 1;
+    const uint8_t SOLUTION_KNOWN = 2;
+    const uint8_t NO_SOLUTION = 4;
+
+    const uint32_t INDEX_MASK = 0xFFFFFFFFu;
+
+    // Minimal tokenizer for the text commands
+    struct Tokens
+    {
+        const char *position;
+        const char *end;
+
+        bool word(const char *&start, size_t &length)
+        {
+            while (position < end && (*position == ' ' || *position == '\t' || *position == '\r'))
+            {
+                position++;
+            }
+            start = position;
+            while (position < end && *position != ' ' && *position != '\t' && *position != '\r')
+            {
+                position++;
+            }
+            length = static_cast<size_t>(position - start);
+            return length > 0;
+        }
+
+        bool number(uint64_t &value)
+        {
+            const char *start;
+            size_t length;
+            if (!word(start, length) || length > 20)
+            {
+                return false;
+            }
+            value = 0;
+            for (size_t i = 0; i < length; i++)
+            {
+                if (start[i] < '0' || start[i] > '9')
+                {
+                    return false;
+                }
+                value = value * 10 + static_cast<uint64_t>(start[i] - '0');
+            }
+            return true;
+        }
+    };
+
+    bool equals(const char *word, size_t length, const char *keyword)
+    {
+        return std::strlen(keyword) == length && std::memcmp(word, keyword, length) == 0;
+    }
+
+    size_t replyText(char *reply, const char *text)
+    {
+        size_t length = std::strlen(text);
+        std::memcpy(reply, text, length);
+        return length;
+    }
+
+    size_t replyError(char *reply, SessionResult result)
+    {
+        return static_cast<size_t>(
+            std::snprintf(reply, SudokuSessionManager::MAX_REPLY, "ERR %s", SudokuSessionManager::resultName(result)));
+    }
+}
+
+SudokuSessionManager::SudokuSessionManager(uint32_t maxSessions, SudokuPuzzleBuffer *stock)
+    : maxSessions(maxSessions), stock(stock), activeSessions(0), allocatedSessions(0)
+{
+}
+
+SudokuSessionManager::Session *SudokuSessionManager::find(SessionId id)
+{
+    uint32_t index = static_cast<uint32_t>(id & INDEX_MASK);
+    if (index >= allocatedSessions)
+    {
+        return nullptr;
+    }
+    Session &session = slabs[index / SLAB_SIZE][index % SLAB_SIZE];
+    if (!(session.flags & IN_USE) || session.generation != static_cast<uint32_t>(id >> 32))
+    {
+        return nullptr;
+    }
+    return &session;
+}
+
+const SudokuSessionManager::Session *SudokuSessionManager::find(SessionId id) const
+{
+    return const_cast<SudokuSessionManager *>(this)->find(id);
+}
+
+bool SudokuSessionManager::isGiven(const Session &session, int cell)
+{
+    return (session.givens[cell >> 3] >> (cell & 7)) & 1;
+}
+
+SessionResult SudokuSessionManager::create(const uint8_t *cells, SessionId &id)
+{
+    for (int cell = 0; cell < 81; cell++)
+    {
+        if (cells[cell] > 9)
+        {
+            return SessionResult::BAD_ARGUMENT;
+        }
+    }
+
+    uint32_t index;
+    if (!freeSlots.empty())
+    {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        if (allocatedSessions >= maxSessions)
+        {
+            return SessionResult::LIMIT;
+        }
+        if (allocatedSessions % SLAB_SIZE == 0)
+        {
+            slabs.emplace_back(new Session[SLAB_SIZE]());
+        }
+        index = allocatedSessions++;
+    }
+
+    Session &session = slabs[index / SLAB_SIZE][index % SLAB_SIZE];
+    uint32_t generation = session.generation + 1;
+    session = Session();
+    session.generation = generation;
+    session.flags = IN_USE;
+    std::memcpy(session.cells, cells, 81);
+    for (int cell = 0; cell < 81; cell++)
+    {
+        if (cells[cell] != 0)
+        {
+            session.givens[cell >> 3] |= static_cast<uint8_t>(1u << (cell & 7));
+        }
+    }
+
+    activeSessions++;
+    id = (static_cast<SessionId>(generation) << 32) | index;
+    return SessionResult::OK;
+}
+
+SessionResult SudokuSessionManager::close(SessionId id)
+{
+    Session *session = find(id);
+    if (session == nullptr)
+    {
+        return SessionResult::NO_SESSION;
+    }
+    session->flags = 0;
+    freeSlots.push_back(static_cast<uint32_t>(id & INDEX_MASK));
+    activeSessions--;
+    return SessionResult::OK;
+}
+
+void SudokuSessionManager::applyMove(Session &session, const Move &move, bool forward)
+{
+    session.cells[move.cell] = forward ? move.newValue : move.oldValue;
+}
+
+SessionResult SudokuSessionManager::move(SessionId id, int row, int col, int value)
+{
+    Session *session = find(id);
+    if (session == nullptr)
+    {
+        return SessionResult::NO_SESSION;
+    }
+    if (row < 0 || row > 8 || col < 0 || col > 8 || value < 0 || value > 9)
+    {
+        return SessionResult::BAD_ARGUMENT;
+    }
+
+    int cell = row * 9 + col;
+    if (isGiven(*session, cell))
+    {
+        return SessionResult::GIVEN;
+    }
+    if (value != 0)
+    {
+        if (session->cells[cell] != 0)
+        {
+            return SessionResult::OCCUPIED;
+        }
+        for (int peer : PEERS[cell])
+        {
+            if (session->cells[peer] == value)
+            {
+                return SessionResult::ILLEGAL;
+            }
+        }
+    }
+
+    Move move{static_cast<uint8_t>(cell), session->cells[cell], static_cast<uint8_t>(value), false};
+    applyMove(*session, move, true);
+    session->history.record(move);
+    return SessionResult::OK;
+}
+
+SessionResult SudokuSessionManager::undo(SessionId id)
+{
+    Session *session = find(id);
+    if (session == nullptr)
+    {
+        return SessionResult::NO_SESSION;
+    }
+    Move move;
+    if (!session->history.undo(move))
+    {
+        return SessionResult::NO_UNDO;
+    }
+    applyMove(*session, move, false);
+    return SessionResult::OK;
+}
+
+SessionResult SudokuSessionManager::redo(SessionId id)
+{
+    Session *session = find(id);
+    if (session == nullptr)
+    {
+        return SessionResult::NO_SESSION;
+    }
+    Move move;
+    if (!session->history.redo(move))
+    {
+        return SessionResult::NO_REDO;
+    }
+    applyMove(*session, move, true);
+    return SessionResult::OK;
+}
+
+bool SudokuSessionManager::ensureSolution(Session &session)
+{
+    if (session.flags & SOLUTION_KNOWN)
+    {
+        return true;
+    }
+    if (session.flags & NO_SOLUTION)
+    {
+        return false;
+    }
+
+    // Solve from the givens alone so the player's mistakes do not get in the way
+    SudokuBoard board;
+    auto &rows = board.getBoard();
+    for (int cell = 0; cell < 81; cell++)
+    {
+        rows[cell / 9][cell % 9] = isGiven(session, cell) ? session.cells[cell] : 0;
+    }
+    if (!SudokuSolver::solve(board))
+    {
+        session.flags |= NO_SOLUTION;
+        return false;
+    }
+
+    uint8_t solved[81];
+    for (int cell = 0; cell < 81; cell++)
+    {
+        solved[cell] = static_cast<uint8_t>(rows[cell / 9][cell % 9]);
+    }
+    SudokuBoard::packCells(solved, session.solution);
+    session.flags |= SOLUTION_KNOWN;
+    return true;
+}
+
+SessionResult SudokuSessionManager::hint(SessionId id, int &row, int &col, int &value)
+{
+    Session *session = find(id);
+    if (session == nullptr)
+    {
+        return SessionResult::NO_SESSION;
+    }
+    if (!ensureSolution(*session))
+    {
+        return SessionResult::UNSOLVABLE;
+    }
+
+    uint8_t solved[81];
+    SudokuBoard::unpackCells(session->solution, solved);
+
+    int empty = -1;
+    for (int cell = 0; cell < 81; cell++)
+    {
+        if (session->cells[cell] == 0)
+        {
+            if (empty < 0)
+            {
+                empty = cell;
+            }
+        }
+        else if (session->cells[cell] != solved[cell])
+        {
+            row = cell / 9;
+            col = cell % 9;
+            value = solved[cell];
+            return SessionResult::WRONG_ENTRY;
+        }
+    }
+    if (empty < 0)
+    {
+        return SessionResult::SOLVED;
+    }
+
+    row = empty / 9;
+    col = empty % 9;
+    value = solved[empty];
+    Move move{static_cast<uint8_t>(empty), 0, static_cast<uint8_t>(value), false};
+    applyMove(*session, move, true);
+    session->history.record(move);
+    return SessionResult::OK;
+}
+
+SessionResult SudokuSessionManager::solve(SessionId id)
+{
+    Session *session = find(id);
+    if (session == nullptr)
+    {
+        return SessionResult::NO_SESSION;
+    }
+    if (!ensureSolution(*session))
+    {
+        return SessionResult::UNSOLVABLE;
+    }
+    SudokuBoard::unpackCells(session->solution, session->cells);
+    session->history.clear();
+    return SessionResult::OK;
+}
+
+SessionResult SudokuSessionManager::cells(SessionId id, uint8_t *out) const
+{
+    const Session *session = find(id);
+    if (session == nullptr)
+    {
+        return SessionResult::NO_SESSION;
+    }
+    std::memcpy(out, session->cells, 81);
+    return SessionResult::OK;
+}
+
+size_t SudokuSessionManager::memoryUsage() const
+{
+    return slabs.size() * SLAB_SIZE * sizeof(Session) + freeSlots.capacity() * sizeof(uint32_t) +
+           slabs.capacity() * sizeof(slabs[0]);
+}
+
+const char *SudokuSessionManager::resultName(SessionResult result)
+{
+    switch (result)
+    {
+    case SessionResult::OK:
+        return "ok";
+    case SessionResult::NO_SESSION:
+        return "no-session";
+    case SessionResult::LIMIT:
+        return "session-limit";
+    case SessionResult::BAD_ARGUMENT:
+        return "bad-argument";
+    case SessionResult::GIVEN:
+        return "given";
+    case SessionResult::OCCUPIED:
+        return "occupied";
+    case SessionResult::ILLEGAL:
+        return "illegal";
+    case SessionResult::NO_UNDO:
+        return "nothing-to-undo";
+    case SessionResult::NO_REDO:
+        return "nothing-to-redo";
+    case SessionResult::WRONG_ENTRY:
+        return "wrong-entry";
+    case SessionResult::UNSOLVABLE:
+        return "unsolvable";
+    case SessionResult::SOLVED:
+        return "solved";
+    }
+    return "unknown";
+}
+
+size_t SudokuSessionManager::execute(const char *line, size_t length, char *reply)
+{
+    Tokens tokens{line, line + length};
+    const char *command;
+    size_t commandLength;
+    if (!tokens.word(command, commandLength))
+    {
+        return replyError(reply, SessionResult::BAD_ARGUMENT);
+    }
+
+    if (equals(command, commandLength, "STATS"))
+    {
+        return static_cast<size_t>(std::snprintf(reply, MAX_REPLY, "OK %zu %zu", sessionCount(), memoryUsage()));
+    }
+
+    if (equals(command, commandLength, "NEW"))
+    {
+        const char *argument;
+        size_t argumentLength;
+        if (!tokens.word(argument, argumentLength))
+        {
+            return replyError(reply, SessionResult::BAD_ARGUMENT);
+        }
+
+        uint8_t puzzle[81];
+        if (argumentLength == 81)
+        {
+            for (int cell = 0; cell < 81; cell++)
+            {
+                char c = argument[cell];
+                if (c != '.' && (c < '0' || c > '9'))
+                {
+                    return replyError(reply, SessionResult::BAD_ARGUMENT);
+                }
+                puzzle[cell] = c == '.' ? 0 : static_cast<uint8_t>(c - '0');
+            }
+        }
+        else
+        {
+            Difficulty difficulty;
+            if (equals(argument, argumentLength, "easy"))
+                difficulty = Difficulty::EASY;
+            else if (equals(argument, argumentLength, "medium"))
+                difficulty = Difficulty::MEDIUM;
+            else if (equals(argument, argumentLength, "hard"))
+                difficulty = Difficulty::HARD;
+            else
+                return replyError(reply, SessionResult::BAD_ARGUMENT);
+
+            if (stock != nullptr)
+            {
+                if (!stock->take(difficulty, puzzle))
+                {
+                    return 0;
+                }
+            }
+            else
+            {
+                SudokuBoard board = SudokuGenerator::generatePuzzle(difficulty);
+                for (int cell = 0; cell < 81; cell++)
+                {
+                    puzzle[cell] = static_cast<uint8_t>(board.getValue(cell / 9, cell % 9));
+                }
+            }
+        }
+
+        SessionId id;
+        SessionResult result = create(puzzle, id);
+        if (result != SessionResult::OK)
+        {
+            return replyError(reply, result);
+        }
+        return static_cast<size_t>(std::snprintf(reply, MAX_REPLY, "OK %llu", static_cast<unsigned long long>(id)));
+    }
+
+    uint64_t id;
+    if (!tokens.number(id))
+    {
+        return replyError(reply, SessionResult::BAD_ARGUMENT);
+    }
+
+    SessionResult result;
+    if (equals(command, commandLength, "MOVE"))
+    {
+        uint64_t row, col, value;
+        if (!tokens.number(row) || !tokens.number(col) || !tokens.number(value) || row == 0 || col == 0 ||
+            row > 9 || col > 9)
+        {
+            return replyError(reply, SessionResult::BAD_ARGUMENT);
+        }
+        result = move(id, static_cast<int>(row) - 1, static_cast<int>(col) - 1, static_cast<int>(value));
+    }
+    else if (equals(command, commandLength, "UNDO"))
+    {
+        result = undo(id);
+    }
+    else if (equals(command, commandLength, "REDO"))
+    {
+        result = redo(id);
+    }
+    else if (equals(command, commandLength, "SOLVE"))
+    {
+        result = solve(id);
+    }
+    else if (equals(command, commandLength, "CLOSE"))
+    {
+        result = close(id);
+    }
+    else if (equals(command, commandLength, "HINT"))
+    {
+        int row, col, value;
+        result = hint(id, row, col, value);
+        if (result == SessionResult::OK || result == SessionResult::WRONG_ENTRY)
+        {
+            return static_cast<size_t>(std::snprintf(reply, MAX_REPLY, "%s %d %d %d",
+                                                     result == SessionResult::OK ? "OK" : "WRONG", row + 1, col + 1,
+                                                     value));
+        }
+    }
+    else if (equals(command, commandLength, "SHOW"))
+    {
+        uint8_t grid[81];
+        result = cells(id, grid);
+        if (result == SessionResult::OK)
+        {
+            size_t size = replyText(reply, "OK ");
+            for (int cell = 0; cell < 81; cell++)
+            {
+                reply[size++] = grid[cell] == 0 ? '.' : static_cast<char>('0' + grid[cell]);
+            }
+            return size;
+        }
+    }
+    else
+    {
+        return replyError(reply, SessionResult::BAD_ARGUMENT);
+    }
+
+    return result == SessionResult::OK ? replyText(reply, "OK") : replyError(reply, result);
+}
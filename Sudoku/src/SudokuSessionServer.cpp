@@ -0,0 +1,190 @@
+#include "SudokuSessionServer.hpp"
+#include "SudokuSocket.hpp"
+
+#ifdef _WIN32
+
+bool SudokuSessionServer::run(const std::string &, SudokuSessionManager &, const std::atomic<bool> &,
+                              SessionServerStats &, int)
+{
+    return false;
+}
+
+#else
+
+#include <poll.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // How often a client waiting for a stocked puzzle retries
+    const int WAIT_MILLIS = 2;
+
+    // Per-connection buffers; a client only costs memory while it is connected
+    struct Client
+    {
+        int socket;
+        std::string input;
+        std::string output;
+        bool waiting; // A NEW is waiting for the stock; nothing more is read until it runs
+    };
+
+    // Run every complete line in the client's input, stopping at a NEW the stock
+    // cannot serve yet; false if a line is too long
+    bool runCommands(Client &client, SudokuSessionManager &manager, SessionServerStats &stats)
+    {
+        char reply[SudokuSessionManager::MAX_REPLY + 1];
+        size_t start = 0;
+        size_t newline;
+        while ((newline = client.input.find('\n', start)) != std::string::npos)
+        {
+            size_t length = manager.execute(client.input.data() + start, newline - start, reply);
+            if (length == 0)
+            {
+                break;
+            }
+            reply[length++] = '\n';
+            client.output.append(reply, length);
+            stats.commands++;
+            start = newline + 1;
+        }
+        client.input.erase(0, start);
+        client.waiting = newline != std::string::npos;
+        return client.waiting || client.input.size() <= SudokuSessionServer::MAX_LINE;
+    }
+
+    // Send what the socket takes now; false if the client is gone
+    bool flushOutput(Client &client)
+    {
+        while (!client.output.empty())
+        {
+            bool wouldBlock;
+            long sent = SudokuSocket::send(client.socket, client.output.data(), client.output.size(), wouldBlock);
+            if (sent < 0)
+            {
+                return wouldBlock;
+            }
+            client.output.erase(0, static_cast<size_t>(sent));
+        }
+        return true;
+    }
+}
+
+bool SudokuSessionServer::run(const std::string &path, SudokuSessionManager &manager, const std::atomic<bool> &stop,
+                              SessionServerStats &stats, int pollMillis)
+{
+    int listener = SudokuSocket::listenUnix(path);
+    if (listener < 0 || !SudokuSocket::setNonBlocking(listener))
+    {
+        SudokuSocket::close(listener);
+        return false;
+    }
+
+    std::vector<Client> clients;
+    std::vector<pollfd> polls;
+    char buffer[16384];
+
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        // Slot 0 is the listener; client i is slot i + 1. A waiting client is not
+        // read from, so a pipelining client cannot pile up input meanwhile.
+        polls.resize(clients.size() + 1);
+        polls[0] = pollfd{listener, POLLIN, 0};
+        bool anyWaiting = false;
+        for (size_t i = 0; i < clients.size(); i++)
+        {
+            short events = clients[i].waiting ? 0 : POLLIN;
+            if (!clients[i].output.empty())
+            {
+                events |= POLLOUT;
+            }
+            polls[i + 1] = pollfd{clients[i].socket, events, 0};
+            anyWaiting = anyWaiting || clients[i].waiting;
+        }
+
+        int ready = ::poll(polls.data(), polls.size(), anyWaiting ? WAIT_MILLIS : pollMillis);
+        if (ready < 0 || (ready == 0 && !anyWaiting))
+        {
+            continue;
+        }
+
+        for (size_t i = 0; i < clients.size(); i++)
+        {
+            short events = ready > 0 ? polls[i + 1].revents : 0;
+            Client &client = clients[i];
+            bool alive = true;
+
+            if (client.waiting && (events & (POLLHUP | POLLERR)))
+            {
+                alive = false; // Gone before its NEW could run
+            }
+            else if (client.waiting)
+            {
+                alive = runCommands(client, manager, stats);
+            }
+            else if (events & (POLLIN | POLLHUP | POLLERR))
+            {
+                bool wouldBlock;
+                long bytes = SudokuSocket::receive(client.socket, buffer, sizeof(buffer), wouldBlock);
+                if (bytes > 0)
+                {
+                    client.input.append(buffer, static_cast<size_t>(bytes));
+                    alive = runCommands(client, manager, stats);
+                }
+                else if (!wouldBlock)
+                {
+                    alive = false;
+                }
+            }
+            if (alive)
+            {
+                alive = flushOutput(client);
+            }
+            if (!alive)
+            {
+                SudokuSocket::close(client.socket);
+                client.socket = -1;
+            }
+        }
+
+        // Drop closed clients without disturbing the order of the others
+        size_t kept = 0;
+        for (size_t i = 0; i < clients.size(); i++)
+        {
+            if (clients[i].socket >= 0)
+            {
+                if (kept != i)
+                {
+                    clients[kept] = std::move(clients[i]);
+                }
+                kept++;
+            }
+        }
+        clients.resize(kept);
+
+        if (ready > 0 && (polls[0].revents & POLLIN))
+        {
+            int socket;
+            while ((socket = SudokuSocket::accept(listener)) >= 0)
+            {
+                SudokuSocket::setNonBlocking(socket);
+                clients.push_back(Client{socket, std::string(), std::string(), false});
+                stats.connections++;
+            }
+            if (static_cast<long long>(clients.size()) > stats.maxClients)
+            {
+                stats.maxClients = static_cast<long long>(clients.size());
+            }
+        }
+    }
+
+    for (Client &client : clients)
+    {
+        SudokuSocket::close(client.socket);
+    }
+    SudokuSocket::close(listener);
+    SudokuSocket::unlinkPath(path);
+    return true;
+}
+
+#endif
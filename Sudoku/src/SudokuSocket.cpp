@@ -0,0 +1,234 @@
+#include "SudokuSocket.hpp"
+
+#ifdef _WIN32
+
+int SudokuSocket::listenUnix(const std::string &, int) { return -1; }
+int SudokuSocket::connectUnix(const std::string &) { return -1; }
+int SudokuSocket::listenTcp(int, int) { return -1; }
+int SudokuSocket::connectTcp(const std::string &, int) { return -1; }
+int SudokuSocket::accept(int) { return -1; }
+bool SudokuSocket::setNonBlocking(int) { return false; }
+void SudokuSocket::setNoDelay(int) {}
+long SudokuSocket::receive(int, char *, size_t, bool &wouldBlock)
+{
+    wouldBlock = false;
+    return -1;
+}
+long SudokuSocket::send(int, const char *, size_t, bool &wouldBlock)
+{
+    wouldBlock = false;
+    return -1;
+}
+bool SudokuSocket::sendAll(int, const char *, size_t) { return false; }
+void SudokuSocket::close(int) {}
+void SudokuSocket::unlinkPath(const std::string &) {}
+bool SudokuSocket::isSupported() { return false; }
+
+#else
+
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Platforms without it rely on SIGPIPE being ignored by the caller
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace
+{
+    bool makeAddress(const std::string &path, sockaddr_un &address)
+    {
+        if (path.empty() || path.size() >= sizeof(address.sun_path))
+        {
+            return false;
+        }
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+}
+
+int SudokuSocket::listenUnix(const std::string &path, int backlog)
+{
+    sockaddr_un address;
+    if (!makeAddress(path, address))
+    {
+        return -1;
+    }
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        return -1;
+    }
+
+    ::unlink(path.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, backlog) != 0)
+    {
+        ::close(listener);
+        return -1;
+    }
+    return listener;
+}
+
+int SudokuSocket::connectUnix(const std::string &path)
+{
+    sockaddr_un address;
+    if (!makeAddress(path, address))
+    {
+        return -1;
+    }
+
+    int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket < 0)
+    {
+        return -1;
+    }
+    if (::connect(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        ::close(socket);
+        return -1;
+    }
+    return socket;
+}
+
+int SudokuSocket::listenTcp(int port, int backlog)
+{
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        return -1;
+    }
+
+    int reuse = 1;
+    ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, backlog) != 0)
+    {
+        ::close(listener);
+        return -1;
+    }
+    return listener;
+}
+
+int SudokuSocket::connectTcp(const std::string &host, int port)
+{
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (::inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1)
+    {
+        return -1;
+    }
+
+    int socket = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (socket < 0)
+    {
+        return -1;
+    }
+    if (::connect(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        ::close(socket);
+        return -1;
+    }
+
+    setNoDelay(socket);
+    return socket;
+}
+
+int SudokuSocket::accept(int listener)
+{
+    int socket;
+    do
+    {
+        socket = ::accept(listener, nullptr, nullptr);
+    } while (socket < 0 && errno == EINTR);
+    return socket;
+}
+
+bool SudokuSocket::setNonBlocking(int socket)
+{
+    int flags = ::fcntl(socket, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+void SudokuSocket::setNoDelay(int socket)
+{
+    int noDelay = 1;
+    ::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+}
+
+long SudokuSocket::receive(int socket, char *buffer, size_t size, bool &wouldBlock)
+{
+    long bytes;
+    do
+    {
+        bytes = static_cast<long>(::read(socket, buffer, size));
+    } while (bytes < 0 && errno == EINTR);
+    wouldBlock = bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    return bytes;
+}
+
+long SudokuSocket::send(int socket, const char *data, size_t size, bool &wouldBlock)
+{
+    long bytes;
+    do
+    {
+        // MSG_NOSIGNAL: a vanished client is an error return, not SIGPIPE
+        bytes = static_cast<long>(::send(socket, data, size, MSG_NOSIGNAL));
+    } while (bytes < 0 && errno == EINTR);
+    wouldBlock = bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    return bytes;
+}
+
+bool SudokuSocket::sendAll(int socket, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        bool wouldBlock;
+        long bytes = send(socket, data, size, wouldBlock);
+        if (bytes <= 0)
+        {
+            return false;
+        }
+        data += bytes;
+        size -= static_cast<size_t>(bytes);
+    }
+    return true;
+}
+
+void SudokuSocket::close(int socket)
+{
+    if (socket >= 0)
+    {
+        ::close(socket);
+    }
+}
+
+void SudokuSocket::unlinkPath(const std::string &path)
+{
+    ::unlink(path.c_str());
+}
+
+bool SudokuSocket::isSupported()
+{
+    return true;
+}
+
+#endif
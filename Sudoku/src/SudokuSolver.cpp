@@ -1,63 +1,455 @@
 #include "SudokuSolver.hpp"
+#include "SudokuBits.hpp"
+#include "SudokuValidator.hpp"
+
+using namespace SudokuBits;
+
+namespace {
+    // Digit masks per unit plus the list of cells still to fill
+    struct SearchState {
+        uint16_t rows[9];
+        uint16_t cols[9];
+        uint16_t boxes[9];
+        uint8_t empty[81];
+        int emptyCount;
+    };
+
+    // Load the board into a search state; false if the givens already clash
+    bool loadState(const SudokuBoard& board, SearchState& state) {
+        state = SearchState{};
+        const auto& cells = board.getBoard();
+
+        for (int cell = 0; cell < 81; cell++) {
+            int value = cells[rowOf(cell)][colOf(cell)];
+            if (value == 0) {
+                state.empty[state.emptyCount++] = static_cast<uint8_t>(cell);
+                continue;
+            }
+
+            int bit = 1 << (value - 1);
+            if ((state.rows[rowOf(cell)] | state.cols[colOf(cell)] | state.boxes[boxOf(cell)]) & bit) {
+                return false;
+            }
+            state.rows[rowOf(cell)] |= bit;
+            state.cols[colOf(cell)] |= bit;
+            state.boxes[boxOf(cell)] |= bit;
+        }
+        return true;
+    }
+
+    int freeDigits(const SearchState& state, int cell) {
+        return ~(state.rows[rowOf(cell)] | state.cols[colOf(cell)] | state.boxes[boxOf(cell)]) & ALL_DIGITS;
+    }
+
+    // Depth-first count with minimum-remaining-values branching; nodes counts the digits tried.
+    // Once cancel (if given) is set every call returns 0, so the count unwinds unfinished
+    int countRecursive(SearchState& state, int limit, long long& nodes, const std::atomic<bool>* cancel) {
+        if (state.emptyCount == 0) {
+            return 1;
+        }
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            return 0;
+        }
+
+        // Pick the empty cell with the fewest candidates
+        int bestIndex = 0;
+        int bestCount = 10;
+        for (int i = 0; i < state.emptyCount; i++) {
+            int count = popCount(freeDigits(state, state.empty[i]));
+            if (count < bestCount) {
+                bestCount = count;
+                bestIndex = i;
+                if (count <= 1) {
+                    break;
+                }
+            }
+        }
+        if (bestCount == 0) {
+            return 0;
+        }
+
+        int cell = state.empty[bestIndex];
+        state.empty[bestIndex] = state.empty[--state.emptyCount];
+
+        int solutions = 0;
+        for (int candidates = freeDigits(state, cell); candidates && solutions < limit; candidates &= candidates - 1) {
+            int bit = candidates & -candidates;
+            state.rows[rowOf(cell)] |= bit;
+            state.cols[colOf(cell)] |= bit;
+            state.boxes[boxOf(cell)] |= bit;
+
+            nodes++;
+            solutions += countRecursive(state, limit - solutions, nodes, cancel);
+
+            state.rows[rowOf(cell)] ^= bit;
+            state.cols[colOf(cell)] ^= bit;
+            state.boxes[boxOf(cell)] ^= bit;
+        }
+
+        state.empty[state.emptyCount++] = state.empty[bestIndex];
+        state.empty[bestIndex] = static_cast<uint8_t>(cell);
+        return solutions;
+    }
+
+    // Candidate masks for constraint propagation; placed cells have had their
+    // digit removed from every peer
+    struct PropagationGrid {
+        uint16_t candidates[81];
+        uint8_t placed[81];
+        int remaining;
+    };
+
+    // Where propagation ran dry
+    struct Failure {
+        SolveResult result;
+        int cell;
+        int unit;
+        int digit;
+    };
+
+    bool fail(Failure* failure, SolveResult result, int cell, int unit, int digit) {
+        if (failure) {
+            *failure = Failure{result, cell, unit, digit};
+        }
+        return false;
+    }
+
+    bool isSingle(unsigned mask) {
+        return (mask & (mask - 1)) == 0;
+    }
+
+    // Place every cell on the stack (each holds a single candidate) and strip its
+    // digit from the peers, following any new singles that creates
+    bool placeCells(PropagationGrid& grid, uint8_t* stack, int top, Failure* failure) {
+        while (top > 0) {
+            int cell = stack[--top];
+            if (grid.placed[cell]) {
+                continue;
+            }
+            grid.placed[cell] = 1;
+            grid.remaining--;
+
+            uint16_t bit = grid.candidates[cell];
+            for (int peer : PEERS[cell]) {
+                if (!(grid.candidates[peer] & bit)) {
+                    continue;
+                }
+                grid.candidates[peer] ^= bit;
+                if (grid.candidates[peer] == 0) {
+                    return fail(failure, SolveResult::EMPTY_CELL, peer, -1, 0);
+                }
+                if (isSingle(grid.candidates[peer])) {
+                    stack[top++] = static_cast<uint8_t>(peer);
+                }
+            }
+        }
+        return true;
+    }
+
+    // Naked and hidden singles to a fixed point; false on a contradiction
+    bool propagate(PropagationGrid& grid, Failure* failure) {
+        uint8_t stack[81];
+        int top = 0;
+        for (int cell = 0; cell < 81; cell++) {
+            if (!grid.placed[cell] && isSingle(grid.candidates[cell])) {
+                if (grid.candidates[cell] == 0) {
+                    return fail(failure, SolveResult::EMPTY_CELL, cell, -1, 0);
+                }
+                stack[top++] = static_cast<uint8_t>(cell);
+            }
+        }
+
+        bool progress = true;
+        while (progress) {
+            if (!placeCells(grid, stack, top, failure)) {
+                return false;
+            }
+            top = 0;
+            progress = false;
+
+            for (int unit = 0; unit < 27; unit++) {
+                unsigned once = 0;
+                unsigned twice = 0;
+                for (int cell : UNITS[unit]) {
+                    twice |= once & grid.candidates[cell];
+                    once |= grid.candidates[cell];
+                }
+                if (once != ALL_DIGITS) {
+                    return fail(failure, SolveResult::MISSING_DIGIT, -1, unit,
+                                lowestBit(~once & ALL_DIGITS) + 1);
+                }
+
+                unsigned hidden = once & ~twice;
+                if (!hidden) {
+                    continue;
+                }
+                for (int cell : UNITS[unit]) {
+                    unsigned only = grid.candidates[cell] & hidden;
+                    if (only && !grid.placed[cell] && !isSingle(grid.candidates[cell])) {
+                        if (!isSingle(only)) {
+                            // Two digits that each fit only here
+                            return fail(failure, SolveResult::MISSING_DIGIT, -1, unit,
+                                        lowestBit(only & (only - 1)) + 1);
+                        }
+                        grid.candidates[cell] = static_cast<uint16_t>(only);
+                        stack[top++] = static_cast<uint8_t>(cell);
+                        progress = true;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // Candidates implied by the givens in cells (0 = blank); givens are placed
+    // during the first propagation
+    void loadGrid(const uint8_t* cells, PropagationGrid& grid) {
+        grid.remaining = 81;
+        for (int cell = 0; cell < 81; cell++) {
+            grid.candidates[cell] = cells[cell] ? static_cast<uint16_t>(1u << (cells[cell] - 1)) : ALL_DIGITS;
+            grid.placed[cell] = 0;
+        }
+    }
+
+    // Depth-first search over propagated grids, branching on the fewest candidates;
+    // nodes counts the branches tried. Gives up (returning false) as soon as cancel
+    // is raised.
+    bool searchGrid(PropagationGrid& grid, const std::atomic<bool>* cancel, long long& nodes) {
+        if (grid.remaining == 0) {
+            return true;
+        }
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        int best = -1;
+        int bestCount = 10;
+        for (int cell = 0; cell < 81; cell++) {
+            if (grid.placed[cell]) {
+                continue;
+            }
+            int count = popCount(grid.candidates[cell]);
+            if (count < bestCount) {
+                bestCount = count;
+                best = cell;
+                if (count == 2) {
+                    break;
+                }
+            }
+        }
+
+        // A digit with only two places in a unit branches as narrowly as a bivalue cell
+        if (bestCount > 2) {
+            for (int unit = 0; unit < 27; unit++) {
+                unsigned once = 0;
+                unsigned twice = 0;
+                unsigned more = 0;
+                for (int cell : UNITS[unit]) {
+                    unsigned c = grid.placed[cell] ? 0 : grid.candidates[cell];
+                    more |= twice & c;
+                    twice |= once & c;
+                    once |= c;
+                }
+                unsigned pairs = twice & ~more;
+                if (!pairs) {
+                    continue;
+                }
+                unsigned bit = pairs & -pairs;
+                for (int cell : UNITS[unit]) {
+                    if (grid.placed[cell] || !(grid.candidates[cell] & bit)) {
+                        continue;
+                    }
+                    PropagationGrid next = grid;
+                    next.candidates[cell] = static_cast<uint16_t>(bit);
+                    nodes++;
+                    if (propagate(next, nullptr) && searchGrid(next, cancel, nodes)) {
+                        grid = next;
+                        return true;
+                    }
+                }
+                return false;
+            }
+        }
+
+        for (unsigned candidates = grid.candidates[best]; candidates; candidates &= candidates - 1) {
+            PropagationGrid next = grid;
+            next.candidates[best] = static_cast<uint16_t>(candidates & -candidates);
+            nodes++;
+            if (propagate(next, nullptr) && searchGrid(next, cancel, nodes)) {
+                grid = next;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool propagationFails(const uint8_t* cells, Failure* failure) {
+        PropagationGrid grid;
+        loadGrid(cells, grid);
+        return !propagate(grid, failure);
+    }
+
+    // Read the board into digits; false if a value is out of range
+    bool readCells(const SudokuBoard& board, uint8_t* cells) {
+        const auto& rows = board.getBoard();
+        for (int cell = 0; cell < 81; cell++) {
+            int value = rows[rowOf(cell)][colOf(cell)];
+            if (value < 0 || value > 9) {
+                return false;
+            }
+            cells[cell] = static_cast<uint8_t>(value);
+        }
+        return true;
+    }
+}
 
 bool SudokuSolver::solve(SudokuBoard& board) {
-    return solveRecursive(board);
+    Contradiction contradiction;
+    return solve(board, contradiction) == SolveResult::SOLVED;
 }
 
-bool SudokuSolver::solveRecursive(SudokuBoard& board) {
-    int row, col;
-    
-    // Find next empty cell
-    if (!findEmptyCell(board, row, col)) {
-        // No empty cell found, puzzle is solved
+SolveResult SudokuSolver::solve(SudokuBoard& board, Contradiction& contradiction, const std::atomic<bool>* cancel,
+                                SolverStats* stats) {
+    if (findContradiction(board, contradiction)) {
+        return contradiction.result;
+    }
+
+    uint8_t cells[81];
+    readCells(board, cells);
+    PropagationGrid grid;
+    loadGrid(cells, grid);
+    long long nodes = 0;
+    bool solved = propagate(grid, nullptr) && searchGrid(grid, cancel, nodes);
+    if (stats) {
+        stats->nodes += nodes;
+    }
+    if (!solved) {
+        // Consistent under propagation, but every branch dies deeper in the search
+        contradiction = Contradiction{};
+        bool cancelled = cancel && cancel->load(std::memory_order_relaxed);
+        contradiction.result = cancelled ? SolveResult::CANCELLED : SolveResult::NO_SOLUTION;
+        return contradiction.result;
+    }
+
+    auto& rows = board.getBoard();
+    for (int cell = 0; cell < 81; cell++) {
+        rows[rowOf(cell)][colOf(cell)] = lowestBit(grid.candidates[cell]) + 1;
+    }
+    contradiction = Contradiction{};
+    return SolveResult::SOLVED;
+}
+
+bool SudokuSolver::findContradiction(const SudokuBoard& board, Contradiction& contradiction) {
+    contradiction = Contradiction{};
+
+    uint8_t cells[81];
+    if (!readCells(board, cells)) {
+        contradiction.result = SolveResult::DUPLICATE_GIVEN;
         return true;
     }
-    
-    // Try values 1-9
-    for (int num = 1; num <= 9; num++) {
-        if (board.isValidMove(row, col, num)) {
-            // Temporarily place the number
-            board.getBoard()[row][col] = num;
-            
-            // Recursively solve
-            if (solveRecursive(board)) {
+
+    // Repeated givens: the two cells are the whole explanation
+    int unit = SudokuValidator::firstConflictingUnit(cells);
+    if (unit != SudokuValidator::VALID) {
+        int firstCell[10] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+        for (int cell : UNITS[unit]) {
+            int digit = cells[cell];
+            if (digit == 0) {
+                continue;
+            }
+            if (firstCell[digit] >= 0) {
+                contradiction.result = SolveResult::DUPLICATE_GIVEN;
+                contradiction.unit = unit;
+                contradiction.digit = digit;
+                contradiction.givens = {firstCell[digit], cell};
                 return true;
             }
-            
-            // Backtrack if solution not found
-            board.getBoard()[row][col] = 0;
+            firstCell[digit] = cell;
         }
     }
-    
-    // No solution found
-    return false;
+
+    if (!propagationFails(cells, nullptr)) {
+        return false;
+    }
+
+    // Drop every given propagation can do without; what is left is a set in
+    // which each given is needed for the contradiction
+    for (int cell = 0; cell < 81; cell++) {
+        if (cells[cell] == 0) {
+            continue;
+        }
+        uint8_t given = cells[cell];
+        cells[cell] = 0;
+        if (!propagationFails(cells, nullptr)) {
+            cells[cell] = given;
+        }
+    }
+
+    Failure failure{SolveResult::NO_SOLUTION, -1, -1, 0};
+    propagationFails(cells, &failure);
+    contradiction.result = failure.result;
+    contradiction.cell = failure.cell;
+    contradiction.unit = failure.unit;
+    contradiction.digit = failure.digit;
+    for (int cell = 0; cell < 81; cell++) {
+        if (cells[cell] != 0) {
+            contradiction.givens.push_back(cell);
+        }
+    }
+    return true;
 }
 
+std::string SudokuSolver::describe(const SudokuBoard& board, const Contradiction& contradiction) {
+    std::string text;
+    switch (contradiction.result) {
+    case SolveResult::SOLVED:
+        return "solved";
+    case SolveResult::DUPLICATE_GIVEN:
+        text = contradiction.unit < 0 ? "value out of range"
+                                      : std::to_string(contradiction.digit) + " appears twice in " +
+                                            SudokuValidator::unitName(contradiction.unit);
+        break;
+    case SolveResult::EMPTY_CELL:
+        text = "no digit fits cell r" + std::to_string(rowOf(contradiction.cell) + 1) + "c" +
+               std::to_string(colOf(contradiction.cell) + 1);
+        break;
+    case SolveResult::MISSING_DIGIT:
+        text = std::to_string(contradiction.digit) + " has no place in " +
+               SudokuValidator::unitName(contradiction.unit);
+        break;
+    case SolveResult::NO_SOLUTION:
+        return "no solution (found by exhaustive search)";
+    case SolveResult::CANCELLED:
+        return "search cancelled";
+    }
+
+    if (!contradiction.givens.empty()) {
+        text += "; conflicting givens:";
+        for (int cell : contradiction.givens) {
+            text += " r" + std::to_string(rowOf(cell) + 1) + "c" + std::to_string(colOf(cell) + 1) + "=" +
+                    std::to_string(board.getValue(rowOf(cell), colOf(cell)));
+        }
+    }
+    return text;
+}
+
+
 bool SudokuSolver::isValidBoard(const SudokuBoard& board) {
     const auto& boardData = board.getBoard();
-    
-    // Check each cell
+
+    // Read-only: one pass to bytes, then one digit mask per unit
+    uint8_t cells[81];
     for (int i = 0; i < 9; i++) {
         for (int j = 0; j < 9; j++) {
             int value = boardData[i][j];
-            
-            if (value != 0) {
-                // Temporarily remove the value to check validity
-                const_cast<SudokuBoard&>(board).getBoard()[i][j] = 0;
-                
-                bool isValid = board.isValidMove(i, j, value);
-                
-                // Restore the value
-                const_cast<SudokuBoard&>(board).getBoard()[i][j] = value;
-                
-                if (!isValid) {
-                    return false;
-                }
+            if (value < 0 || value > 9) {
+                return false;
             }
+            cells[i * 9 + j] = static_cast<uint8_t>(value);
         }
     }
-    
-    return true;
+
+    return SudokuValidator::firstConflictingUnit(cells) == SudokuValidator::VALID;
 }
 
 bool SudokuSolver::findEmptyCell(const SudokuBoard& board, int& row, int& col) {
@@ -71,4 +463,53 @@ bool SudokuSolver::findEmptyCell(const SudokuBoard& board, int& row, int& col) {
         }
     }
     return false;
+}
+
+int SudokuSolver::countSolutions(const SudokuBoard& board, int maxSolutions, SolverStats* stats,
+                                 const std::atomic<bool>* cancel) {
+    SearchState state;
+    if (maxSolutions <= 0 || !loadState(board, state)) {
+        return 0;
+    }
+    long long nodes = 0;
+    int solutions = countRecursive(state, maxSolutions, nodes, cancel);
+    if (stats) {
+        stats->nodes += nodes;
+    }
+    return solutions;
+}
+
+bool SudokuSolver::hasSolutionWithout(const SudokuBoard& board, int row, int col, int value) {
+    SearchState state;
+    if (!loadState(board, state)) {
+        return false;
+    }
+
+    int cell = row * 9 + col;
+    int index = 0;
+    while (index < state.emptyCount && state.empty[index] != cell) {
+        index++;
+    }
+    if (index == state.emptyCount) {
+        return false; // Cell is not empty
+    }
+    state.empty[index] = state.empty[--state.emptyCount];
+
+    int candidates = freeDigits(state, cell) & ~(1 << (value - 1));
+    for (; candidates; candidates &= candidates - 1) {
+        int bit = candidates & -candidates;
+        state.rows[row] |= bit;
+        state.cols[col] |= bit;
+        state.boxes[boxOf(cell)] |= bit;
+
+        long long nodes = 0;
+        if (countRecursive(state, 1, nodes, nullptr) > 0) {
+            return true;
+        }
+
+        state.rows[row] ^= bit;
+        state.cols[col] ^= bit;
+        state.boxes[boxOf(cell)] ^= bit;
+    }
+    return false;
 }
\ No newline at end of file
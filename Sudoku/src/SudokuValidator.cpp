@@ -0,0 +1,145 @@
+#include "SudokuValidator.hpp"
+#include "SudokuBits.hpp"
+
+using namespace SudokuBits;
+
+namespace
+{
+    const int LANES = SudokuValidator::LANES;
+
+    // Digit bit of each byte value; anything outside 1-9 gets a bit no unit mask can match
+    struct DigitBits
+    {
+        uint16_t bit[256];
+
+        DigitBits() : bit()
+        {
+            for (int v = 0; v < 256; v++)
+            {
+                bit[v] = (v >= 1 && v <= 9) ? static_cast<uint16_t>(1u << (v - 1)) : 0x8000;
+            }
+        }
+    };
+
+    const DigitBits DIGIT_BITS;
+}
+
+int SudokuValidator::firstInvalidUnit(const uint8_t *cells)
+{
+    uint16_t bits[81];
+    for (int cell = 0; cell < 81; cell++)
+    {
+        bits[cell] = DIGIT_BITS.bit[cells[cell]];
+    }
+
+    for (int unit = 0; unit < 27; unit++)
+    {
+        const auto &members = UNITS[unit];
+        unsigned seen = 0;
+        for (int cell : members)
+        {
+            seen |= bits[cell];
+        }
+        // Nine cells covering nine digits means each digit appears exactly once
+        if (seen != ALL_DIGITS)
+        {
+            return unit;
+        }
+    }
+    return VALID;
+}
+
+int SudokuValidator::firstConflictingUnit(const uint8_t *cells)
+{
+    for (int unit = 0; unit < 27; unit++)
+    {
+        unsigned seen = 0;
+        for (int cell : UNITS[unit])
+        {
+            if (cells[cell] == 0)
+            {
+                continue;
+            }
+            unsigned bit = DIGIT_BITS.bit[cells[cell]];
+            if ((seen & bit) || bit > ALL_DIGITS)
+            {
+                return unit;
+            }
+            seen |= bit;
+        }
+    }
+    return VALID;
+}
+
+long long SudokuValidator::validate(const uint8_t *grids, long long count, int8_t *units)
+{
+    long long valid = 0;
+    long long i = 0;
+    for (; i + LANES <= count; i += LANES)
+    {
+        valid += validateLanes(grids + i * 81, units + i);
+    }
+    for (; i < count; i++)
+    {
+        units[i] = static_cast<int8_t>(firstInvalidUnit(grids + i * 81));
+        valid += units[i] == VALID;
+    }
+    return valid;
+}
+
+int SudokuValidator::validateLanes(const uint8_t *grids, int8_t *units)
+{
+    // Transpose to [cell][lane] so each unit reduction is a vector OR across grids
+    alignas(32) uint16_t bits[81][LANES];
+    for (int l = 0; l < LANES; l++)
+    {
+        const uint8_t *cells = grids + l * 81;
+        for (int cell = 0; cell < 81; cell++)
+        {
+            bits[cell][l] = DIGIT_BITS.bit[cells[cell]];
+        }
+    }
+
+    alignas(32) uint16_t bad[LANES] = {0};
+    for (const auto &unit : UNITS)
+    {
+        alignas(32) uint16_t seen[LANES] = {0};
+        for (int cell : unit)
+        {
+            for (int l = 0; l < LANES; l++)
+            {
+                seen[l] |= bits[cell][l];
+            }
+        }
+        for (int l = 0; l < LANES; l++)
+        {
+            bad[l] |= seen[l] ^ ALL_DIGITS;
+        }
+    }
+
+    // Invalid grids are the rare case; rescan only those to name the unit
+    int valid = 0;
+    for (int l = 0; l < LANES; l++)
+    {
+        if (bad[l])
+        {
+            units[l] = static_cast<int8_t>(firstInvalidUnit(grids + l * 81));
+        }
+        else
+        {
+            units[l] = VALID;
+            valid++;
+        }
+    }
+    return valid;
+}
+
+std::string SudokuValidator::unitName(int unit)
+{
+    if (unit < 0 || unit >= 27)
+    {
+        return "none";
+    }
+    static const char *const KINDS[3] = {"row ", "column ", "box "};
+    return KINDS[unit / 9] + std::to_string(unit % 9 + 1);
+}
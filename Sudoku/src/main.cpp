@@ -1,8 +1,14 @@
 #include "SudokuGame.hpp"
+#include "SudokuCli.hpp"
 #include <iostream>
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
+        // Any arguments select a headless subcommand instead of the interactive game
+        if (argc > 1) {
+            return SudokuCli::run(argc, argv);
+        }
+
         SudokuGame game;
         game.run();
     } catch (const std::exception& e) {
@@ -14,4 +20,4 @@ int main() {
     }
     
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,95 @@
+#include "SudokuJournal.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+// Round trip of the autosave journal: write a session, replay it, then cut the
+// last record in half and check replay drops it, resume cuts it off and later
+// records land on a record boundary.
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, const char *what)
+    {
+        if (!condition)
+        {
+            std::fprintf(stderr, "FAILED: %s\n", what);
+            failures++;
+        }
+    }
+
+    Move move(int cell, int oldValue, int newValue, bool chained = false)
+    {
+        return Move{static_cast<uint8_t>(cell), static_cast<uint8_t>(oldValue), static_cast<uint8_t>(newValue),
+                    chained};
+    }
+}
+
+int main()
+{
+    std::string filename = (std::filesystem::temp_directory_path() / "SudokuJournalTest.journal").string();
+
+    SudokuBoard puzzle;
+    puzzle.setValue(0, 0, 5);
+    puzzle.setValue(8, 8, 9);
+
+    // Moves on cells 1, 2 and 3 (3 chained to 2), undo the chain, redo it, then cell 4
+    SudokuJournal journal;
+    check(journal.begin(filename, puzzle), "begin");
+    check(journal.appendMove(move(1, 0, 3)), "append move");
+    check(journal.appendMove(move(2, 0, 4)), "append move");
+    check(journal.appendMove(move(3, 0, 6, true)), "append chained move");
+    check(journal.appendUndo() && journal.appendUndo(), "append undo");
+    check(journal.appendRedo() && journal.appendRedo(), "append redo");
+    check(journal.appendMove(move(4, 0, 7)), "append move");
+    journal.close();
+
+    SudokuBoard start;
+    SudokuBoard board;
+    SudokuMoveHistory history;
+    long validLength = 0;
+    check(SudokuJournal::replay(filename, start, board, history, validLength), "replay");
+    check(start.getValue(0, 0) == 5 && start.getValue(8, 8) == 9 && start.getValue(0, 1) == 0, "puzzle restored");
+    check(board.getValue(0, 1) == 3 && board.getValue(0, 2) == 4 && board.getValue(0, 3) == 6 &&
+              board.getValue(0, 4) == 7,
+          "moves replayed");
+    check(history.undoDepth() == 4 && history.redoDepth() == 0, "history depth");
+    check(validLength == static_cast<long>(std::filesystem::file_size(filename)), "whole file valid");
+
+    // Chained flag survives the round trip
+    Move last;
+    check(history.undo(last) && last.cell == 4 && !last.chained, "last move");
+    check(history.undo(last) && last.cell == 3 && last.chained, "chained move");
+
+    // A torn final record (half of the move on cell 4) is dropped
+    long fullLength = validLength;
+    std::filesystem::resize_file(filename, static_cast<uintmax_t>(fullLength - 2));
+    check(SudokuJournal::replay(filename, start, board, history, validLength), "replay torn");
+    check(validLength == fullLength - 4, "torn record excluded");
+    check(board.getValue(0, 4) == 0 && board.getValue(0, 3) == 6, "torn move not applied");
+    check(history.undoDepth() == 3, "torn history depth");
+
+    // Resuming cuts the torn bytes off, so a new record replays cleanly
+    check(journal.resume(filename, validLength), "resume");
+    check(journal.appendMove(move(5, 0, 8)), "append after resume");
+    journal.close();
+    check(SudokuJournal::replay(filename, start, board, history, validLength), "replay resumed");
+    check(board.getValue(0, 5) == 8 && board.getValue(0, 4) == 0, "resumed move replayed");
+    check(validLength == static_cast<long>(std::filesystem::file_size(filename)), "resumed file valid");
+
+    // Garbage after the last record is ignored
+    std::FILE *out = std::fopen(filename.c_str(), "ab");
+    std::fputc('Z', out);
+    std::fclose(out);
+    check(SudokuJournal::replay(filename, start, board, history, validLength), "replay garbage");
+    check(board.getValue(0, 5) == 8 && validLength == static_cast<long>(std::filesystem::file_size(filename)) - 1,
+          "garbage skipped");
+
+    std::remove(filename.c_str());
+    if (failures == 0)
+    {
+        std::printf("journal round trip: ok\n");
+    }
+    return failures == 0 ? 0 : 1;
+}